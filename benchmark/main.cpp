@@ -0,0 +1,916 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include <signals-cpp/signals.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+// count all heap allocations, so the benchmarks can report allocations per operation;
+// additionally count the allocations and deallocations of each thread on its own. The
+// complete set of the replaceable forms gets replaced, so array, `std::nothrow` and (if
+// supported) aligned allocations get counted as well; the counting itself stays out of
+// line, so the optimizer does not pair an inlined `std::free()` with a `new` expression.
+static std::atomic<long long> g_allocations(0);
+static SIGNALS_CPP_THREAD_LOCAL long long t_heap_ops = 0;
+
+#if defined(__GNUC__)
+#  define SIGNALS_CPP_BENCH_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#  define SIGNALS_CPP_BENCH_NOINLINE __declspec(noinline)
+#else
+#  define SIGNALS_CPP_BENCH_NOINLINE
+#endif
+
+SIGNALS_CPP_BENCH_NOINLINE static void* counted_alloc(std::size_t size) SIGNALS_CPP_NOEXCEPT {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    ++t_heap_ops;
+    return std::malloc(size ? size : 1);
+}
+SIGNALS_CPP_BENCH_NOINLINE static void counted_free(void* p) SIGNALS_CPP_NOEXCEPT {
+    if(p) { ++t_heap_ops; }
+    std::free(p);
+}
+
+void* operator new(std::size_t size) {
+    if(auto p = counted_alloc(size)) { return p; }
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+    if(auto p = counted_alloc(size)) { return p; }
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size, std::nothrow_t const&) SIGNALS_CPP_NOEXCEPT { return counted_alloc(size); }
+void* operator new[](std::size_t size, std::nothrow_t const&) SIGNALS_CPP_NOEXCEPT { return counted_alloc(size); }
+
+void operator delete(void* p) SIGNALS_CPP_NOEXCEPT { counted_free(p); }
+void operator delete[](void* p) SIGNALS_CPP_NOEXCEPT { counted_free(p); }
+void operator delete(void* p, std::size_t) SIGNALS_CPP_NOEXCEPT { counted_free(p); }
+void operator delete[](void* p, std::size_t) SIGNALS_CPP_NOEXCEPT { counted_free(p); }
+void operator delete(void* p, std::nothrow_t const&) SIGNALS_CPP_NOEXCEPT { counted_free(p); }
+void operator delete[](void* p, std::nothrow_t const&) SIGNALS_CPP_NOEXCEPT { counted_free(p); }
+
+#if defined(__cpp_aligned_new)
+SIGNALS_CPP_BENCH_NOINLINE static void* counted_aligned_alloc(std::size_t size, std::align_val_t alignment) noexcept {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    ++t_heap_ops;
+    auto a = static_cast<std::size_t>(alignment);
+#  if defined(_MSC_VER)
+    return _aligned_malloc(size ? size : 1, a);
+#  else
+    return std::aligned_alloc(a, (size ? ((size + a - 1) / a * a) : a)); // the size needs to be a multiple of the alignment
+#  endif
+}
+SIGNALS_CPP_BENCH_NOINLINE static void counted_aligned_free(void* p) noexcept {
+    if(p) { ++t_heap_ops; }
+#  if defined(_MSC_VER)
+    _aligned_free(p);
+#  else
+    std::free(p);
+#  endif
+}
+
+void* operator new(std::size_t size, std::align_val_t a) {
+    if(auto p = counted_aligned_alloc(size, a)) { return p; }
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size, std::align_val_t a) {
+    if(auto p = counted_aligned_alloc(size, a)) { return p; }
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size, std::align_val_t a, std::nothrow_t const&) noexcept { return counted_aligned_alloc(size, a); }
+void* operator new[](std::size_t size, std::align_val_t a, std::nothrow_t const&) noexcept { return counted_aligned_alloc(size, a); }
+
+void operator delete(void* p, std::align_val_t) noexcept { counted_aligned_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { counted_aligned_free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { counted_aligned_free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { counted_aligned_free(p); }
+void operator delete(void* p, std::align_val_t, std::nothrow_t const&) noexcept { counted_aligned_free(p); }
+void operator delete[](void* p, std::align_val_t, std::nothrow_t const&) noexcept { counted_aligned_free(p); }
+#endif // defined(__cpp_aligned_new)
+
+namespace {
+
+    typedef std::chrono::steady_clock clock_type;
+
+    inline double seconds_since(clock_type::time_point start) {
+        return std::chrono::duration<double>(clock_type::now() - start).count();
+    }
+
+    /// Fires the same signal with 4 connected slots from `threads` threads
+    /// concurrently and reports the aggregated number of `fire()` calls per
+    /// second.
+    void bench_fire_contention(int threads, int fires_per_thread) {
+        signals::signal<void(int& counter)> sig;
+        for(int i = 0; i < 4; ++i) { sig.connect([](int& counter) { ++counter; }); }
+
+        std::atomic<bool> go(false);
+        std::vector<std::thread> workers;
+        for(int t = 0; t < threads; ++t) {
+            workers.emplace_back([&]() {
+                while(!go) { std::this_thread::yield(); }
+                int counter = 0;
+                for(int i = 0; i < fires_per_thread; ++i) { sig.fire(counter); }
+                if(counter != 4 * fires_per_thread) { std::abort(); }
+            });
+        }
+
+        auto start = clock_type::now();
+        go = true;
+        for(auto&& w : workers) { w.join(); }
+        auto elapsed = seconds_since(start);
+
+        auto total = double(threads) * fires_per_thread;
+        std::printf("fire contention   threads: %2d   fires/s: %12.0f   ns/fire: %8.1f\n",
+            threads, total / elapsed, elapsed * 1e9 / total);
+    }
+
+    /// Fires a signal from `threads` threads while another thread keeps a read
+    /// section open (a slot running for the whole measurement pins an old epoch) and
+    /// a third one keeps retiring snapshots of another signal via connect churn; so
+    /// each `fire()` finds unreclaimable objects in the retired list.
+    void bench_fire_pinned(int threads, int fires_per_thread) {
+        signals::signal<void()> pinning;
+        std::atomic<bool> pinned(false), done(false);
+        pinning.connect([&]() { pinned = true; while(!done) { std::this_thread::yield(); } });
+        std::thread pinner([&]() { pinning.fire(); });
+        while(!pinned) { std::this_thread::yield(); }
+
+        signals::signal<void(int)> churned;
+        std::thread churner([&]() {
+            while(!done) { churned.connect([](int) { }).disconnect(); std::this_thread::yield(); }
+        });
+
+        signals::signal<void(int& counter)> sig;
+        for(int i = 0; i < 4; ++i) { sig.connect([](int& counter) { ++counter; }); }
+
+        auto start = clock_type::now();
+        std::vector<std::thread> workers;
+        for(int t = 0; t < threads; ++t) {
+            workers.emplace_back([&]() {
+                int counter = 0;
+                for(int i = 0; i < fires_per_thread; ++i) { sig.fire(counter); }
+                if(counter != 4 * fires_per_thread) { std::abort(); }
+            });
+        }
+        for(auto&& w : workers) { w.join(); }
+        auto elapsed = seconds_since(start);
+
+        done = true;
+        pinner.join();
+        churner.join();
+
+        std::printf("fire pinned epoch threads: %2d   ns/fire: %8.1f\n",
+            threads, elapsed * 1e9 / (double(threads) * fires_per_thread));
+    }
+
+    /// Fires a signal with `slots` connected slots on a single thread and
+    /// reports the time spent per `fire()` and per slot invocation.
+    template<typename SIGNAL = signals::signal<void(int& counter)>>
+    void bench_fire_fanout(int slots, int fires, const char* name = "std::function") {
+        SIGNAL sig;
+        for(int i = 0; i < slots; ++i) { sig.connect([](int& counter) { ++counter; }); }
+
+        int counter = 0;
+        auto start = clock_type::now();
+        for(int i = 0; i < fires; ++i) { sig.fire(counter); }
+        auto elapsed = seconds_since(start);
+        if(counter != slots * fires) { std::abort(); }
+
+        std::printf("fire fan-out      %-22s slots: %2d   ns/fire: %8.1f   ns/slot: %6.2f\n",
+            name, slots, elapsed * 1e9 / fires, elapsed * 1e9 / (double(fires) * slots));
+    }
+
+    /// Measures the CPU time burned by `disconnect(true)` while it waits for a
+    /// slot which is blocked (e.g., doing I/O) for `slot_ms` milliseconds.
+    void bench_disconnect_wait(int slot_ms) {
+        signals::signal<void()> sig;
+        std::atomic<bool> entered(false);
+        auto conn = sig.connect([&]() {
+            entered = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(slot_ms));
+        });
+
+        std::thread firing([&]() { sig.fire(); });
+        while(!entered) { std::this_thread::yield(); }
+
+        auto cpu_start = std::clock();
+        auto start = clock_type::now();
+        conn.disconnect(true);
+        auto elapsed = seconds_since(start);
+        auto cpu = double(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+        firing.join();
+
+        std::printf("disconnect wait   slot ms: %2d   wall ms: %8.2f   cpu ms: %8.2f\n",
+            slot_ms, elapsed * 1e3, cpu * 1e3);
+    }
+
+    /// Measures tearing down a `connections` object tracking `conns` connections of
+    /// `signals` different signals, with `busy` of these connections running a slot
+    /// for `slot_ms` milliseconds on other threads.
+    void bench_teardown(int conns, int busy, int slot_ms) {
+        std::vector<signals::signal<void()>> sigs(conns);
+        std::unique_ptr<signals::connections> tracked(new signals::connections());
+        std::atomic<int> entered(0);
+        for(int i = 0; i < conns; ++i) {
+            tracked->connect(sigs[i], [&entered, slot_ms]() {
+                ++entered;
+                std::this_thread::sleep_for(std::chrono::milliseconds(slot_ms));
+            });
+        }
+
+        std::vector<std::thread> firing;
+        for(int i = 0; i < busy; ++i) { firing.emplace_back([&sigs, i]() { sigs[i].fire(); }); }
+        while(entered < busy) { std::this_thread::yield(); }
+
+        auto cpu_start = std::clock();
+        auto start = clock_type::now();
+        tracked->disconnect_all(true);
+        auto elapsed = seconds_since(start);
+        auto cpu = double(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+        for(auto&& t : firing) { t.join(); }
+
+        std::printf("teardown          conns: %4d   busy: %3d   wall ms: %8.3f   cpu ms: %8.3f\n",
+            conns, busy, elapsed * 1e3, cpu * 1e3);
+    }
+
+    /// Measures a `connect()` and `disconnect()` round trip for a slot whose
+    /// lambda captures 40 bytes (too large for the small buffer of most
+    /// `std::function` implementations).
+    template<typename SIGNAL>
+    void bench_connect_churn(const char* name, int rounds) {
+        SIGNAL sig;
+        double a = 1, b = 2, c = 3, d = 4;
+        int counter = 0;
+
+        auto allocations = g_allocations.load();
+        auto start = clock_type::now();
+        for(int i = 0; i < rounds; ++i) {
+            auto conn = sig.connect([a, b, c, d, &counter](int v) { counter += int(a + b + c + d) + v; });
+            conn.disconnect();
+        }
+        auto elapsed = seconds_since(start);
+        allocations = g_allocations.load() - allocations;
+
+        std::printf("connect churn     %-28s ns/connect: %8.1f   allocations/connect: %4.2f\n",
+            name, elapsed * 1e9 / rounds, double(allocations) / rounds);
+    }
+
+    /// Measures building up `slots` subscriptions to the same signal.
+    void bench_connect_scaling(int slots) {
+        signals::signal<void(int& counter)> sig;
+        std::vector<signals::connection> conns;
+        conns.reserve(slots);
+
+        auto start = clock_type::now();
+        for(int i = 0; i < slots; ++i) { conns.push_back(sig.connect([](int& counter) { ++counter; })); }
+        auto elapsed = seconds_since(start);
+
+        std::printf("connect scaling   slots: %6d   ms total: %8.2f   ns/connect: %8.1f\n",
+            slots, elapsed * 1e3, elapsed * 1e9 / slots);
+    }
+
+    /// Measures connecting `slots` slots with random priorities out of `groups` groups.
+    void bench_connect_priorities(int slots, int groups) {
+        signals::signal<void(int& counter)> sig;
+        std::vector<signals::connection> conns;
+        conns.reserve(slots);
+        std::srand(42);
+
+        auto start = clock_type::now();
+        for(int i = 0; i < slots; ++i) { conns.push_back(sig.connect(std::rand() % groups, [](int& counter) { ++counter; })); }
+        auto elapsed = seconds_since(start);
+
+        int counter = 0;
+        sig.fire(counter);
+        if(counter != slots) { std::abort(); }
+
+        std::printf("connect priority  slots: %6d   groups: %4d   ns/connect: %8.1f\n",
+            slots, groups, elapsed * 1e9 / slots);
+    }
+
+    /// Measures connecting `slots` slots to the same signal with a single `connect_all()` call.
+    void bench_connect_all(int slots) {
+        signals::signal<void(int& counter)> sig;
+        std::vector<std::function<void(int& counter)>> targets(slots, [](int& counter) { ++counter; });
+
+        auto start = clock_type::now();
+        auto conns = sig.connect_all(targets);
+        auto elapsed = seconds_since(start);
+
+        std::printf("connect all       slots: %6d   ms total: %8.2f   ns/connect: %8.1f\n",
+            slots, elapsed * 1e3, elapsed * 1e9 / slots);
+    }
+
+    /// Connects `slots` slots, disconnects all but every `keep_every`-th one
+    /// and reports the time per `fire()` afterwards (no further `connect()`).
+    void bench_fire_tombstones(int slots, int keep_every, int fires) {
+        signals::signal<void(int& counter)> sig;
+        std::vector<signals::connection> conns;
+        for(int i = 0; i < slots; ++i) { conns.push_back(sig.connect([](int& counter) { ++counter; })); }
+        for(int i = 0; i < slots; ++i) { if(i % keep_every) { conns[i].disconnect(); } }
+
+        int counter = 0;
+        auto start = clock_type::now();
+        for(int i = 0; i < fires; ++i) { sig.fire(counter); }
+        auto elapsed = seconds_since(start);
+        if(counter != ((slots + keep_every - 1) / keep_every) * fires) { std::abort(); }
+
+        std::printf("fire tombstones   slots: %6d   live: %6d   ns/fire: %10.1f\n",
+            slots, (slots + keep_every - 1) / keep_every, elapsed * 1e9 / fires);
+    }
+
+    /// Collects the return values of 10 slots via the `sum` combiner, compared to the
+    /// workaround of capturing an output vector in each slot.
+    void bench_fire_collect(int fires) {
+        signals::signal<int(int v)> sig;
+        for(int i = 0; i < 10; ++i) { sig.connect([](int v) { return v; }); }
+
+        long long total = 0;
+        auto start = clock_type::now();
+        for(int i = 0; i < fires; ++i) { total += sig.fire_collect(signals::combiners::sum<int>(), 1); }
+        auto elapsed = seconds_since(start);
+        if(total != 10LL * fires) { std::abort(); }
+        std::printf("fire collect      %-28s ns/fire: %8.1f\n", "combiners::sum", elapsed * 1e9 / fires);
+
+        signals::signal<void(int v)> out_sig;
+        std::vector<int> results;
+        for(int i = 0; i < 10; ++i) { out_sig.connect([&results](int v) { results.push_back(v); }); }
+
+        total = 0;
+        start = clock_type::now();
+        for(int i = 0; i < fires; ++i) {
+            std::vector<int>().swap(results); // a fresh output vector per fire
+            out_sig.fire(1);
+            for(auto v : results) { total += v; }
+        }
+        elapsed = seconds_since(start);
+        if(total != 10LL * fires) { std::abort(); }
+        std::printf("fire collect      %-28s ns/fire: %8.1f\n", "captured output vector", elapsed * 1e9 / fires);
+    }
+
+    /// Routes an event to 20 handlers of which the first one handles it.
+    void bench_fire_until_handled(int fires) {
+        signals::signal<bool(int key)> sig;
+        for(int i = 0; i < 20; ++i) { sig.connect([i](int key) { return (key == i); }); }
+
+        int handled = 0;
+        auto start = clock_type::now();
+        for(int i = 0; i < fires; ++i) { handled += sig.fire_until_handled(0); }
+        auto elapsed = seconds_since(start);
+        if(handled != fires) { std::abort(); }
+        std::printf("event routing     %-28s ns/fire: %8.1f\n", "fire_until_handled", elapsed * 1e9 / fires);
+
+        handled = 0;
+        start = clock_type::now();
+        for(int i = 0; i < fires; ++i) { sig.fire(0); ++handled; }
+        elapsed = seconds_since(start);
+        std::printf("event routing     %-28s ns/fire: %8.1f\n", "fire (all slots)", elapsed * 1e9 / fires);
+    }
+
+    inline void spin_for(double us) {
+        auto end = clock_type::now() + std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double, std::micro>(us));
+        while(clock_type::now() < end) { }
+    }
+
+    /// Compares the time the producer is blocked per `fire()` with 4 slots doing
+    /// about 2us of work each, synchronously and via `fire_async()`.
+    void bench_fire_async(int fires) {
+        signals::signal<void(int v)> sig;
+        std::atomic<int> calls(0);
+        for(int i = 0; i < 4; ++i) { sig.connect([&calls](int) { spin_for(2.0); ++calls; }); }
+
+        auto start = clock_type::now();
+        for(int i = 0; i < fires; ++i) { sig.fire(i); }
+        auto elapsed = seconds_since(start);
+        std::printf("fire async        %-22s producer ns/fire: %9.1f\n", "fire", elapsed * 1e9 / fires);
+
+        calls = 0;
+        double total = 0;
+        {
+            signals::thread_pool pool;
+            start = clock_type::now();
+            for(int i = 0; i < fires; ++i) { sig.post(pool, i); }
+            elapsed = seconds_since(start);
+        } // drains the pool
+        total = seconds_since(start);
+        if(calls != 4 * fires) { std::abort(); }
+        std::printf("fire async        %-22s producer ns/fire: %9.1f   total ns/fire: %9.1f   workers: %u\n",
+            "post(thread_pool)", elapsed * 1e9 / fires, total * 1e9 / fires, unsigned(signals::thread_pool::default_thread_count()));
+    }
+
+    /// Fires a signal with `slots` targets doing `work_us` of work each serially and
+    /// via `fire_parallel_on()` with a pool of `threads` workers.
+    void bench_fire_parallel(int slots, double work_us, unsigned threads, int fires) {
+        signals::signal<int(int v)> sig;
+        for(int i = 0; i < slots; ++i) { sig.connect([work_us](int v) { if(work_us > 0) { spin_for(work_us); } return v; }); }
+
+        auto start = clock_type::now();
+        for(int i = 0; i < fires; ++i) { sig.fire(1); }
+        auto serial = seconds_since(start);
+
+        signals::thread_pool pool(threads);
+        signals::parallel_options options;
+        options.chunk_size = 64;
+        options.serial_threshold = 0;
+        options.max_tasks = threads + 1;
+
+        long long sum = 0;
+        start = clock_type::now();
+        for(int i = 0; i < fires; ++i) { sum += sig.fire_parallel_collect_on(pool, options, signals::combiners::sum<long long>(), 1); }
+        auto parallel = seconds_since(start);
+        if(sum != (long long)(slots) * fires) { std::abort(); }
+
+        std::printf("fire parallel     slots: %6d   work us: %4.1f   threads: %2u   serial us/fire: %9.2f   parallel us/fire: %9.2f\n",
+            slots, work_us, threads, serial * 1e6 / fires, parallel * 1e6 / fires);
+    }
+
+    struct add_deltas {
+        void operator()(std::tuple<int>& pending, std::tuple<int>&& latest) const { std::get<0>(pending) += std::get<0>(latest); }
+    };
+
+    /// Fires a `valueChanged`-style signal with 4 slots doing about 1us of work each
+    /// `fires` times with a flush after every `window` fires, compared to firing it directly.
+    void bench_coalescing(int fires, int window) {
+        signals::signal<void(int v)> direct;
+        signals::coalescing_signal<void(int v)> latest;
+        signals::coalescing_signal<void(int v), add_deltas> merged;
+        long long sum = 0;
+        for(int i = 0; i < 4; ++i) {
+            direct.connect([&sum](int v) { spin_for(1.0); sum += v; });
+            latest.connect([&sum](int v) { spin_for(1.0); sum += v; });
+            merged.connect([&sum](int v) { spin_for(1.0); sum += v; });
+        }
+
+        auto start = clock_type::now();
+        for(int i = 0; i < fires; ++i) { direct.fire(1); }
+        auto elapsed = seconds_since(start);
+        std::printf("coalescing        %-30s window: %5d   ns/fire: %8.1f\n", "signal::fire", window, elapsed * 1e9 / fires);
+
+        auto allocations = g_allocations.load();
+        start = clock_type::now();
+        for(int i = 0; i < fires; ++i) { latest.fire(1); if((i % window) == 0) { latest.flush(); } }
+        elapsed = seconds_since(start);
+        allocations = g_allocations.load() - allocations;
+        std::printf("coalescing        %-30s window: %5d   ns/fire: %8.1f   allocations/fire: %4.2f\n", "coalescing_signal", window, elapsed * 1e9 / fires, double(allocations) / fires);
+
+        sum = 0;
+        start = clock_type::now();
+        for(int i = 0; i < fires; ++i) { merged.fire(1); if((i % window) == 0) { merged.flush(); } }
+        merged.flush();
+        elapsed = seconds_since(start);
+        if(sum != 4LL * fires) { std::abort(); }
+        std::printf("coalescing        %-30s window: %5d   ns/fire: %8.1f\n", "coalescing_signal<add_deltas>", window, elapsed * 1e9 / fires);
+    }
+
+    /// Measures the cost of a `fire()` of a signal with a single plain or throttled
+    /// slot, with the throttle either passing or suppressing (nearly) all calls.
+    void bench_throttle(int fires) {
+        signals::signal<void(int v)> sig;
+        long long sum = 0;
+
+        auto run = [&](const char* name, signals::throttle const* limit) {
+            auto conn = (limit ? sig.connect(*limit, [&sum](int v) { sum += v; }) : sig.connect([&sum](int v) { sum += v; }));
+            auto start = clock_type::now();
+            for(int i = 0; i < fires; ++i) { sig.fire(1); }
+            auto elapsed = seconds_since(start);
+            conn.disconnect();
+            std::printf("throttle          %-36s ns/fire: %6.1f", name, elapsed * 1e9 / fires);
+            if(limit) { std::printf("   delivered: %9llu   suppressed: %9llu", (unsigned long long)limit->delivered(), (unsigned long long)limit->suppressed()); }
+            std::printf("\n");
+        };
+
+        run("plain slot", nullptr);
+        signals::throttle passing(1000000000, std::chrono::seconds(1));
+        run("throttled slot (passing)", &passing);
+        signals::throttle suppressing(100, std::chrono::seconds(1));
+        run("throttled slot (suppressing)", &suppressing);
+        if(sum == 0) { std::abort(); }
+    }
+
+    /// Delivers `events` events in batches of `batch` events to `slots` slots: calling
+    /// `fire()` per event, `fire_batch()` with plain slots and with batch-aware slots.
+    void bench_fire_batch(int slots, int batch, int events) {
+        typedef signals::signal<void(int v, double d)> signal_type;
+        events -= (events % batch);
+        std::vector<signal_type::args_tuple> tuples;
+        for(int i = 0; i < batch; ++i) { tuples.emplace_back(1, 2.0); }
+
+        signal_type sig;
+        long long sum = 0;
+        std::vector<signals::connection> conns;
+        for(int i = 0; i < slots; ++i) { conns.push_back(sig.connect([&sum](int v, double) { sum += v; })); }
+
+        auto start = clock_type::now();
+        for(int i = 0; i < events; i += batch) {
+            for(auto& t : tuples) { sig.fire(std::get<0>(t), std::get<1>(t)); }
+        }
+        auto elapsed = seconds_since(start);
+        std::printf("fire batch        %-24s slots: %3d   batch: %5d   ns/event: %8.1f\n", "fire per event", slots, batch, elapsed * 1e9 / events);
+
+        start = clock_type::now();
+        for(int i = 0; i < events; i += batch) { sig.fire_batch(tuples); }
+        elapsed = seconds_since(start);
+        std::printf("fire batch        %-24s slots: %3d   batch: %5d   ns/event: %8.1f\n", "fire_batch", slots, batch, elapsed * 1e9 / events);
+
+        for(auto&& c : conns) { c.disconnect(); }
+        conns.clear();
+        for(int i = 0; i < slots; ++i) {
+            conns.push_back(sig.connect_batch([&sum](signal_type::batch_span b) { for(auto& t : b) { sum += std::get<0>(t); } }));
+        }
+
+        start = clock_type::now();
+        for(int i = 0; i < events; i += batch) { sig.fire_batch(tuples); }
+        elapsed = seconds_since(start);
+        std::printf("fire batch        %-24s slots: %3d   batch: %5d   ns/event: %8.1f\n", "fire_batch (batch slots)", slots, batch, elapsed * 1e9 / events);
+
+        if(sum != 3LL * slots * events) { std::abort(); }
+        for(auto&& c : conns) { c.disconnect(); }
+    }
+
+    /// Compares the threading policies: `fire()` with `slots` slots and a connect
+    /// plus disconnect round trip.
+    template<typename THREADING>
+    void bench_threading(const char* name, int slots, int fires) {
+        signals::signal<void(int& counter), std::function<void(int& counter)>, std::allocator<void>, THREADING> sig;
+        std::vector<signals::connection> conns;
+        for(int i = 0; i < slots; ++i) { conns.push_back(sig.connect([](int& counter) { ++counter; })); }
+
+        int counter = 0;
+        auto start = clock_type::now();
+        for(int i = 0; i < fires; ++i) { sig.fire(counter); }
+        auto fire_elapsed = seconds_since(start);
+        if(counter != slots * fires) { std::abort(); }
+
+        const int churns = fires / 10;
+        start = clock_type::now();
+        for(int i = 0; i < churns; ++i) { sig.connect([](int& c) { ++c; }).disconnect(); }
+        auto churn_elapsed = seconds_since(start);
+
+        std::printf("threading         %-16s slots: %3d   ns/fire: %7.1f   ns/connect+disconnect: %7.1f\n",
+            name, slots, fire_elapsed * 1e9 / fires, churn_elapsed * 1e9 / churns);
+        for(auto&& c : conns) { c.disconnect(); }
+    }
+
+    void add_one(int& counter) { ++counter; }
+    void (* volatile g_add_one)(int& counter) = &add_one; // opaque to the optimizer, so the calls do not get inlined
+
+    /// Compares `fire()` of a `static_signal` with `slots` targets with walking a
+    /// hand-written array of function pointers and with a (single-threaded) `signal`.
+    void bench_static_signal(int fires) {
+        const int slots = 8;
+        typedef void (*func_ptr)(int& counter);
+        func_ptr funcs[slots];
+        for(int i = 0; i < slots; ++i) { funcs[i] = g_add_one; }
+
+        int counter = 0;
+        auto start = clock_type::now();
+        for(int i = 0; i < fires; ++i) {
+            for(int j = 0; j < slots; ++j) { funcs[j](counter); }
+        }
+        auto elapsed = seconds_since(start);
+        std::printf("static signal     %-40s ns/slot: %5.2f\n", "array of function pointers", elapsed * 1e9 / (double(slots) * fires));
+
+        signals::static_signal<void(int& counter), slots, func_ptr> ssig;
+        for(int i = 0; i < slots; ++i) { ssig.connect(g_add_one); }
+        start = clock_type::now();
+        for(int i = 0; i < fires; ++i) { ssig.fire(counter); }
+        elapsed = seconds_since(start);
+        std::printf("static signal     %-40s ns/slot: %5.2f\n", "static_signal<..., 8, func_ptr>", elapsed * 1e9 / (double(slots) * fires));
+
+        signals::signal<void(int& counter), func_ptr, std::allocator<void>, signals::threading::single_threaded> sig;
+        for(int i = 0; i < slots; ++i) { sig.connect(g_add_one); }
+        start = clock_type::now();
+        for(int i = 0; i < fires; ++i) { sig.fire(counter); }
+        elapsed = seconds_since(start);
+        std::printf("static signal     %-40s ns/slot: %5.2f\n", "signal<..., func_ptr, single_threaded>", elapsed * 1e9 / (double(slots) * fires));
+
+        if(counter != 3 * slots * fires) { std::abort(); }
+    }
+
+    /// Fires a signal with 8 slots while another thread keeps connecting and
+    /// disconnecting targets; reports the average and worst `fire()` latency and the
+    /// heap operations (allocations and deallocations) done by the firing thread.
+    template<typename SIGNAL, typename CHURN>
+    void bench_realtime(const char* name, SIGNAL& sig, CHURN churn, int fires) {
+        std::vector<signals::connection> conns;
+        for(int i = 0; i < 8; ++i) { conns.push_back(sig.connect([](int& counter) { ++counter; })); }
+
+        std::atomic<bool> done(false);
+        std::thread writer([&]() { while(!done) { churn(); std::this_thread::yield(); } });
+
+        int counter = 0;
+        double worst = 0, total = 0;
+        const auto heap_ops = t_heap_ops;
+        for(int i = 0; i < fires; ++i) {
+            auto start = clock_type::now();
+            sig.fire(counter);
+            auto elapsed = seconds_since(start);
+            total += elapsed;
+            worst = std::max(worst, elapsed);
+        }
+        const auto fire_heap_ops = t_heap_ops - heap_ops;
+        done = true;
+        writer.join();
+        if(counter < 8 * fires) { std::abort(); }
+
+        std::printf("realtime          %-24s avg ns/fire: %7.1f   max us/fire: %8.1f   heap ops on firing thread: %lld\n",
+            name, total * 1e9 / fires, worst * 1e6, fire_heap_ops);
+        for(auto&& c : conns) { c.disconnect(); }
+    }
+
+    /// Creates and destroys `objects` listener objects, each holding a single
+    /// connection to the same signal, either via a `scoped_connection` or via a
+    /// `connections` container; reports the per-object footprint of the handle and
+    /// the time for connecting, firing once, and disconnecting all of them.
+    template<typename HANDLE, typename CONNECT>
+    void bench_scoped_connection(const char* name, CONNECT connect, int objects) {
+        signals::signal<void(int& counter)> sig;
+        int counter = 0;
+
+        auto start = clock_type::now();
+        {
+            std::vector<HANDLE> handles(objects);
+            for(auto&& h : handles) { connect(h, sig.connect([](int& c) { ++c; })); }
+            sig.fire(counter);
+        }
+        auto elapsed = seconds_since(start);
+        if(counter != objects) { std::abort(); }
+
+        std::printf("scoped connection %-24s bytes/object: %3d   ns/object: %6.1f\n",
+            name, int(sizeof(HANDLE)), elapsed * 1e9 / objects);
+    }
+
+    /// A long-lived `connections` owner keeps `live` connections and subscribes and
+    /// unsubscribes another one `churns` times from each of `threads` threads, half
+    /// of them via `connections::disconnect(id)` and half of them by disconnecting
+    /// the `connection` elsewhere; reports the time per churn and the number of
+    /// tracked connections at the end.
+    void bench_connections_churn(int threads, int live, int churns) {
+        signals::signal<void(int& counter)> sig;
+        signals::connections conns;
+        for(int i = 0; i < live; ++i) { conns.add(sig.connect([](int& c) { ++c; })); }
+
+        auto start = clock_type::now();
+        std::vector<std::thread> workers;
+        for(int t = 0; t < threads; ++t) {
+            workers.emplace_back([&]() {
+                for(int i = 0; i < churns; ++i) {
+                    auto conn = sig.connect([](int& c) { ++c; });
+                    auto id = conns.add(conn);
+                    if(i % 2) { conns.disconnect(id); } else { conn.disconnect(); }
+                }
+            });
+        }
+        for(auto&& w : workers) { w.join(); }
+        auto elapsed = seconds_since(start);
+
+        std::printf("connections churn threads: %d   live: %5d   ns/churn: %6.1f   tracked at the end: %d\n",
+            threads, live, elapsed * 1e9 / (double(threads) * churns), int(conns.size()));
+    }
+
+    /// Delivers events through a queued connection to an `event_loop` which gets
+    /// drained in batches of `batch` events, compared to posting tasks to the loop.
+    void bench_queued_connection(int events, int batch) {
+        events -= (events % batch);
+        signals::event_loop loop;
+        signals::signal<void(int v, double d)> sig;
+        long long sum = 0;
+        auto conn = sig.connect(loop, [&sum](int v, double) { sum += v; });
+
+        auto allocations = g_allocations.load();
+        auto start = clock_type::now();
+        for(int i = 0; i < events; i += batch) {
+            for(int j = 0; j < batch; ++j) { sig.fire(1, 2.0); }
+            loop.poll();
+        }
+        auto elapsed = seconds_since(start);
+        allocations = g_allocations.load() - allocations;
+        if(sum != events) { std::abort(); }
+        std::printf("queued connection %-22s batch: %4d   ns/event: %7.1f   allocations/event: %4.2f\n",
+            "connect(loop, target)", batch, elapsed * 1e9 / events, double(allocations) / events);
+        conn.disconnect();
+
+        sum = 0;
+        auto direct = sig.connect([&sum](int v, double) { sum += v; });
+        allocations = g_allocations.load();
+        start = clock_type::now();
+        for(int i = 0; i < events; i += batch) {
+            for(int j = 0; j < batch; ++j) { sig.post(loop, 1, 2.0); }
+            loop.poll();
+        }
+        elapsed = seconds_since(start);
+        allocations = g_allocations.load() - allocations;
+        if(sum != events) { std::abort(); }
+        std::printf("queued connection %-22s batch: %4d   ns/event: %7.1f   allocations/event: %4.2f\n",
+            "post(loop, args)", batch, elapsed * 1e9 / events, double(allocations) / events);
+        direct.disconnect();
+    }
+
+    struct payload { int values[16]; };
+
+    struct member_slot {
+        member_slot() : sum(0) { }
+        void on_payload(payload const& p) { sum += p.values[0]; }
+        int sum;
+    };
+
+    template<typename SIGNAL, typename CONNECT>
+    void bench_member_slot(const char* name, CONNECT connect, int fires) {
+        member_slot obj;
+        SIGNAL sig;
+        for(int i = 0; i < 10; ++i) { connect(sig, obj); }
+
+        payload p = { { 1 } };
+        auto start = clock_type::now();
+        for(int i = 0; i < fires; ++i) { sig.fire(p); }
+        auto elapsed = seconds_since(start);
+        if(obj.sum != 10 * fires) { std::abort(); }
+
+        std::printf("member slot       %-36s ns/slot: %6.2f\n", name, elapsed * 1e9 / (10.0 * fires));
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* filter = ((argc > 1) ? argv[1] : "");
+
+    if(std::strstr("fire_contention", filter)) {
+        for(int threads = 1; threads <= 64; threads *= 2) {
+            bench_fire_contention(threads, 2000000 / threads);
+        }
+    }
+
+    if(std::strstr("fire_pinned", filter)) {
+        bench_fire_pinned(1, 2000000);
+        bench_fire_pinned(4,  500000);
+    }
+
+    if(std::strstr("fire_fanout", filter)) {
+        bench_fire_fanout(1,  4000000);
+        bench_fire_fanout(10,  400000);
+        bench_fire_fanout(50,  100000);
+
+        typedef signals::signal<void(int& counter), signals::inplace_function<void(int& counter), 32>> inplace_signal;
+        bench_fire_fanout<inplace_signal>(1,  4000000, "inplace_function<32>");
+        bench_fire_fanout<inplace_signal>(10,  400000, "inplace_function<32>");
+        bench_fire_fanout<inplace_signal>(50,  100000, "inplace_function<32>");
+    }
+
+    if(std::strstr("disconnect_wait", filter)) {
+        bench_disconnect_wait(5);
+        bench_disconnect_wait(50);
+    }
+
+    if(std::strstr("teardown", filter)) {
+        bench_teardown(500,   0,  0);
+        bench_teardown(500,   1, 20);
+        bench_teardown(500,  50, 20);
+    }
+
+    if(std::strstr("connect_churn", filter)) {
+        bench_connect_churn<signals::signal<void(int)>>("std::function", 1000000);
+        bench_connect_churn<signals::signal<void(int), signals::inplace_function<void(int), 64>>>("inplace_function<64>", 1000000);
+        bench_connect_churn<signals::signal<void(int), std::function<void(int)>, signals::pool_allocator<void>>>("std::function + pool", 1000000);
+        bench_connect_churn<signals::signal<void(int), signals::inplace_function<void(int), 64>, signals::pool_allocator<void>>>("inplace_function<64> + pool", 1000000);
+    }
+
+    if(std::strstr("connect_scaling", filter)) {
+        bench_connect_scaling(1000);
+        bench_connect_scaling(10000);
+        bench_connect_scaling(30000);
+        bench_connect_all(1000);
+        bench_connect_all(10000);
+        bench_connect_all(30000);
+        bench_connect_priorities(1000, 16);
+        bench_connect_priorities(10000, 16);
+    }
+
+    if(std::strstr("fire_tombstones", filter)) {
+        bench_fire_tombstones(10000, 1,  2000);
+        bench_fire_tombstones(10000, 10, 2000);
+        bench_fire_tombstones(10000, 100, 2000);
+    }
+
+    if(std::strstr("fire_collect", filter)) {
+        bench_fire_collect(1000000);
+    }
+
+    if(std::strstr("fire_async", filter)) {
+        bench_fire_async(100000);
+    }
+
+    if(std::strstr("fire_parallel", filter)) {
+        bench_fire_parallel(10000, 0.0, 1, 200);
+        bench_fire_parallel(10000, 0.0, 3, 200);
+        bench_fire_parallel(1000,  1.0, 1, 50);
+        bench_fire_parallel(1000,  1.0, 3, 50);
+    }
+
+    if(std::strstr("coalescing", filter)) {
+        bench_coalescing(200000, 1);
+        bench_coalescing(200000, 100);
+        bench_coalescing(200000, 10000);
+    }
+
+    if(std::strstr("throttle", filter)) {
+        bench_throttle(4000000);
+    }
+
+    if(std::strstr("fire_batch", filter)) {
+        bench_fire_batch(1,  256,  4000000);
+        bench_fire_batch(10, 256,  1000000);
+        bench_fire_batch(10, 4096, 1000000);
+    }
+
+    if(std::strstr("threading", filter)) {
+        for(int slots = 1; slots <= 10; slots *= 10) {
+            bench_threading<signals::threading::mutex>("mutex", slots, 4000000 / slots);
+            bench_threading<signals::threading::spinlock>("spinlock", slots, 4000000 / slots);
+            bench_threading<signals::threading::single_threaded>("single_threaded", slots, 4000000 / slots);
+        }
+    }
+
+    if(std::strstr("static_signal", filter)) {
+        bench_static_signal(4000000);
+    }
+
+    if(std::strstr("realtime", filter)) {
+        signals::signal<void(int& counter)> sig;
+        bench_realtime("signal", sig, [&]() {
+            for(int i = 0; i < 16; ++i) { sig.connect([](int&) { }).disconnect(); }
+        }, 1000000);
+
+        signals::realtime_signal<void(int& counter)> rt_sig(64);
+        bench_realtime("realtime_signal", rt_sig, [&]() {
+            for(int i = 0; i < 16; ++i) { rt_sig.connect([](int&) { }).disconnect(); }
+            rt_sig.collect();
+            rt_sig.reclaim();
+        }, 1000000);
+    }
+
+    if(std::strstr("scoped_connection", filter)) {
+        bench_scoped_connection<signals::scoped_connection>("scoped_connection",
+            [](signals::scoped_connection& h, signals::connection const& c) { h = signals::scoped_connection(c); }, 1000000);
+        bench_scoped_connection<signals::connections>("connections",
+            [](signals::connections& h, signals::connection const& c) { h.add(c); }, 1000000);
+    }
+
+    if(std::strstr("connections_churn", filter)) {
+        bench_connections_churn(1, 1000, 1000000);
+        bench_connections_churn(4, 1000, 250000);
+    }
+
+    if(std::strstr("queued_connection", filter)) {
+        bench_queued_connection(1000000, 32);
+        bench_queued_connection(1000000, 256);
+    }
+
+    if(std::strstr("fire_until_handled", filter)) {
+        bench_fire_until_handled(1000000);
+    }
+
+    if(std::strstr("member_slot", filter)) {
+        typedef signals::signal<void(payload const&)> payload_signal;
+        bench_member_slot<payload_signal>("connect(obj, &method)",
+            [](payload_signal& sig, member_slot& obj) { sig.connect(&obj, &member_slot::on_payload); }, 400000);
+        bench_member_slot<payload_signal>("connect<T, &T::method>(obj)",
+            [](payload_signal& sig, member_slot& obj) { sig.connect<member_slot, &member_slot::on_payload>(&obj); }, 400000);
+
+        typedef signals::signal<void(payload const&), signals::delegate<void(payload const&)>> delegate_signal;
+        bench_member_slot<delegate_signal>("delegate TARGET",
+            [](delegate_signal& sig, member_slot& obj) { sig.connect<member_slot, &member_slot::on_payload>(&obj); }, 400000);
+    }
+
+    return EXIT_SUCCESS;
+}
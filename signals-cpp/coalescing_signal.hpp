@@ -0,0 +1,254 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "config.hpp"
+#include "event_loop.hpp"
+#include "signal.hpp"
+#include "detail/allocation.hpp"
+#include "detail/apply.hpp"
+
+#if defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
+
+namespace signals {
+
+    namespace coalescing {
+
+        /// The default merge policy of a `coalescing_signal`: the latest arguments
+        /// replace the pending ones.
+        struct keep_last { };
+
+    } // namespace coalescing
+
+    /// A `coalescing_signal` collapses repeated `fire()` calls into a single dispatch:
+    /// `fire()` only stores the arguments in a pending cell and the targets get called
+    /// on the next `flush()` with the latest arguments. The pending cell is a single
+    /// atomic pointer, so `fire()` is lock-free and never calls any target; a spare
+    /// cell gets recycled, so in the steady state no memory gets allocated either.
+    ///
+    /// Instead of just keeping the latest arguments, a `MERGE` policy can combine the
+    /// pending and the latest arguments, e.g., to accumulate deltas. It gets called as
+    /// `merge(pending_args, std::move(latest_args))` with both argument packs stored as
+    /// `std::tuple` and has to store the result in `pending_args`; it must not throw.
+    ///
+    /// The flush window is either controlled explicitly (e.g., call `flush()` once per
+    /// frame) or via `auto_flush(executor)`: then the first `fire()` after a flush posts
+    /// a flush task to the `executor` (e.g., an `event_loop`), and all subsequent fires
+    /// until that task runs get collapsed into it.
+    template<
+        typename SIGNATURE,
+        typename MERGE = coalescing::keep_last,
+        typename TARGET = std::function<SIGNATURE>,
+        typename ALLOCATOR = std::allocator<void>
+    >
+    struct coalescing_signal {
+        typedef signal<SIGNATURE, TARGET, ALLOCATOR>                      signal_type;
+        typedef typename detail::signature_args<SIGNATURE>::args_tuple    args_tuple;
+
+        inline explicit coalescing_signal(MERGE merge = MERGE()) :
+            m_state(std::make_shared<state>(std::move(merge)))
+        { }
+
+        /// Connects a target to the underlying signal (see `signal::connect()`).
+        template<typename... T>
+        inline connection connect(T&&... t) { return m_state->sig.connect(std::forward<T>(t)...); }
+
+        /// Returns the underlying signal which gets fired on `flush()`.
+        inline signal_type& get_signal() { return m_state->sig; }
+
+        /// Lets the first `fire()` after a flush post a task to the `executor` which
+        /// flushes the signal; the `executor` needs to provide a `post(std::function<void()>)`
+        /// method and has to outlive this `coalescing_signal`. Must not be called
+        /// concurrently to `fire()`.
+        template<typename EXECUTOR>
+        inline void auto_flush(EXECUTOR& executor) {
+            m_state->post_flush = [&executor](std::function<void()> task) { executor.post(std::move(task)); };
+        }
+
+        /// Stores the arguments in the pending cell; if there are pending arguments
+        /// already, they get replaced (or merged with the new ones).
+        template<typename... ARGS>
+        inline void fire(ARGS&&... args) const {
+            auto s = m_state.get();
+            s->publish(s->make_cell(std::forward<ARGS>(args)...), std::is_same<MERGE, coalescing::keep_last>());
+
+            if(s->post_flush && !s->scheduled.load(std::memory_order_seq_cst) && !s->scheduled.exchange(true, std::memory_order_seq_cst)) {
+                std::weak_ptr<state> weak = m_state;
+                try {
+                    s->post_flush([weak]() {
+                        if(auto s = weak.lock()) {
+                            s->scheduled.store(false, std::memory_order_seq_cst);
+                            s->flush();
+                        }
+                    });
+                } catch(...) {
+                    s->scheduled.store(false, std::memory_order_seq_cst);
+                    throw;
+                }
+            }
+        }
+
+        /// Fires the underlying signal with the pending arguments (if any); returns
+        /// `false` if there was nothing to flush.
+        inline bool flush() const { return m_state->flush(); }
+
+        /// Drops the pending arguments (if any) without firing the signal; returns
+        /// `false` if there was nothing to drop.
+        inline bool discard() const {
+            auto s = m_state.get();
+            auto c = s->pending.exchange(nullptr, std::memory_order_acquire);
+            if(!c) { return false; }
+            s->recycle(c);
+            return true;
+        }
+
+        /// Returns `true` if there are pending arguments waiting for a flush.
+        inline bool pending() const { return (m_state->pending.load(std::memory_order_acquire) != nullptr); }
+
+    private:
+        struct cell {
+            template<typename... ARGS>
+            inline explicit cell(ARGS&&... a) : args(std::forward<ARGS>(a)...) { }
+
+            args_tuple args;
+        };
+
+        typedef typename detail::rebind_alloc<ALLOCATOR, cell>::type cell_allocator;
+
+        /// Calls the signal with the stored arguments.
+        struct fire_signal {
+            template<typename... ARGS>
+            inline void operator()(ARGS&... args) const { sig.fire(args...); }
+
+            signal_type const& sig;
+        };
+
+        /// The state gets shared with pending flush tasks posted by `auto_flush()`.
+        struct state {
+            inline explicit state(MERGE m) : merge(std::move(m)), pending(nullptr), spare(nullptr), scheduled(false) { }
+            inline ~state() {
+                destroy(pending.load(std::memory_order_relaxed));
+                destroy(spare.load(std::memory_order_relaxed));
+            }
+
+            template<typename... ARGS>
+            inline cell* make_cell(ARGS&&... args) {
+                auto c = spare.exchange(nullptr, std::memory_order_acquire);
+                if(c) {
+                    try {
+                        c->args = args_tuple(std::forward<ARGS>(args)...);
+                    } catch(...) {
+                        recycle(c);
+                        throw;
+                    }
+                    return c;
+                }
+
+                detail::allocation_guard<cell_allocator> mem(alloc);
+                ::new(static_cast<void*>(mem.ptr)) cell(std::forward<ARGS>(args)...);
+                return mem.release();
+            }
+
+            inline void destroy(cell* c) {
+                if(!c) { return; }
+                c->~cell();
+                alloc.deallocate(c, 1);
+            }
+
+            /// Keeps `c` as the spare cell, or frees it if there is one already.
+            inline void recycle(cell* c) {
+                cell* expected = nullptr;
+                if(!spare.compare_exchange_strong(expected, c, std::memory_order_release, std::memory_order_relaxed)) { destroy(c); }
+            }
+
+            // keep the latest arguments: a single exchange
+            inline void publish(cell* c, std::true_type) {
+                auto old = pending.exchange(c, std::memory_order_seq_cst);
+                if(old) { recycle(old); }
+            }
+
+            // merge with the pending arguments: take the pending cell, merge the latest
+            // arguments into it and put it back; if some other thread published a cell in
+            // the meantime that one gets taken and merged in the next round
+            inline void publish(cell* c, std::false_type) {
+                for(;;) {
+                    auto acc = pending.exchange(nullptr, std::memory_order_acquire);
+                    if(acc) {
+                        merge(acc->args, std::move(c->args));
+                        recycle(c);
+                        c = acc;
+                    }
+
+                    cell* expected = nullptr;
+                    if(pending.compare_exchange_strong(expected, c, std::memory_order_seq_cst)) { return; }
+                }
+            }
+
+            inline bool flush() {
+                auto c = pending.exchange(nullptr, std::memory_order_seq_cst);
+                if(!c) { return false; }
+
+                struct cleanup {
+                    inline ~cleanup() { s->recycle(c); }
+                    state* s;
+                    cell*  c;
+                } done = { this, c };
+
+                fire_signal f = { sig };
+                detail::apply(f, c->args);
+                return true;
+            }
+
+            signal_type                                    sig;
+            MERGE                                          merge;
+            cell_allocator                                 alloc;
+            std::atomic<cell*>                             pending;
+            std::atomic<cell*>                             spare;
+            std::atomic<bool>                              scheduled; // a flush task has been posted
+            std::function<void(std::function<void()>)>     post_flush;
+
+        private:
+            state(state const& o); // = delete;
+            state& operator=(state const& o); // = delete;
+        };
+
+        std::shared_ptr<state> m_state;
+
+    private:
+        coalescing_signal(coalescing_signal const& o); // = delete;
+        coalescing_signal& operator=(coalescing_signal const& o); // = delete;
+    };
+
+} // namespace signals
+
+#endif // defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
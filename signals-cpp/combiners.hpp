@@ -0,0 +1,235 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include "config.hpp"
+
+namespace signals {
+
+    namespace detail {
+
+        /// Calls `f(arg)` and returns whether the dispatch of a signal should proceed:
+        /// always `true` if `f` returns `void`, otherwise the (boolean) result of `f`.
+        template<typename F, typename A>
+        inline auto invoke_proceed(F& f, A&& arg) -> typename std::enable_if<std::is_void<decltype(f(std::forward<A>(arg)))>::value, bool>::type {
+            f(std::forward<A>(arg));
+            return true;
+        }
+
+        template<typename F, typename A>
+        inline auto invoke_proceed(F& f, A&& arg) -> typename std::enable_if<!std::is_void<decltype(f(std::forward<A>(arg)))>::value, bool>::type {
+            return static_cast<bool>(f(std::forward<A>(arg)));
+        }
+
+    } // namespace detail
+
+    /// Combiners aggregate the return values of the targets called by
+    /// `signal::fire_collect()` on the fly, without any intermediate container.
+    /// A combiner is a function object which gets called with the return value
+    /// of each called target and which provides the aggregated value via its
+    /// `result()` method (of type `result_type`). If the call operator of a combiner
+    /// returns a `bool`, returning `false` stops the dispatch, so the remaining targets
+    /// are not called anymore once the result is known (e.g., `all_of`, `any_of` and
+    /// `first_non_empty` behave like that). For `signal::fire_parallel_collect()` each
+    /// chunk of targets aggregates into the combiner returned by `neutral()` (which does
+    /// not carry over any initial value or state) and the partial results get combined
+    /// via its `merge()` method (in no particular order). A combiner can be passed as an
+    /// lvalue in order to be inspected after the `fire_collect()` call, e.g.:
+    ///
+    ///     signals::combiners::max<int> cost;
+    ///     sig.fire_collect(cost, request);
+    ///     if(!cost.empty()) { ... cost.result() ... }
+    namespace combiners {
+
+        /// Keeps the return value of the last called target.
+        template<typename T>
+        struct last {
+            typedef T result_type;
+
+            inline last() : m_value(), m_empty(true) { }
+
+            inline void operator()(T value) { m_value = std::move(value); m_empty = false; }
+            inline void merge(last const& o) { if(!o.m_empty) { m_value = o.m_value; m_empty = false; } }
+            inline last neutral() const { return last(); }
+
+            inline bool empty() const { return m_empty; }
+            inline result_type result() const { return m_value; }
+
+        private:
+            T    m_value;
+            bool m_empty;
+        };
+
+        /// Keeps the first return value which converts to `true` (e.g., a non-null
+        /// pointer or a non-empty `std::function`).
+        template<typename T>
+        struct first_non_empty {
+            typedef T result_type;
+
+            inline first_non_empty() : m_value(), m_empty(true) { }
+
+            inline bool operator()(T value) {
+                if(static_cast<bool>(value)) { m_value = std::move(value); m_empty = false; }
+                return m_empty; // done once a non-empty value got found
+            }
+            inline void merge(first_non_empty const& o) { if(m_empty && !o.m_empty) { m_value = o.m_value; m_empty = false; } }
+            inline first_non_empty neutral() const { return first_non_empty(); }
+
+            inline bool empty() const { return m_empty; }
+            inline result_type result() const { return m_value; }
+
+        private:
+            T    m_value;
+            bool m_empty;
+        };
+
+        /// Sums up all return values starting with `init`.
+        template<typename T>
+        struct sum {
+            typedef T result_type;
+
+            inline explicit sum(T init = T()) : m_value(std::move(init)) { }
+
+            inline void operator()(T const& value) { m_value += value; }
+            inline void merge(sum const& o) { m_value += o.m_value; }
+            inline sum neutral() const { return sum(); } // without `init`, which counts only once
+
+            inline result_type result() const { return m_value; }
+
+        private:
+            T m_value;
+        };
+
+        /// Keeps the smallest return value (compared via `operator<`).
+        template<typename T>
+        struct min {
+            typedef T result_type;
+
+            inline min() : m_value(), m_empty(true) { }
+
+            inline void operator()(T value) {
+                if(m_empty || (value < m_value)) { m_value = std::move(value); m_empty = false; }
+            }
+            inline void merge(min const& o) { if(!o.m_empty) { (*this)(o.m_value); } }
+            inline min neutral() const { return min(); }
+
+            inline bool empty() const { return m_empty; }
+            inline result_type result() const { return m_value; }
+
+        private:
+            T    m_value;
+            bool m_empty;
+        };
+
+        /// Keeps the largest return value (compared via `operator<`).
+        template<typename T>
+        struct max {
+            typedef T result_type;
+
+            inline max() : m_value(), m_empty(true) { }
+
+            inline void operator()(T value) {
+                if(m_empty || (m_value < value)) { m_value = std::move(value); m_empty = false; }
+            }
+            inline void merge(max const& o) { if(!o.m_empty) { (*this)(o.m_value); } }
+            inline max neutral() const { return max(); }
+
+            inline bool empty() const { return m_empty; }
+            inline result_type result() const { return m_value; }
+
+        private:
+            T    m_value;
+            bool m_empty;
+        };
+
+        /// `true` if all called targets returned `true` (or no target got called); stops
+        /// at the first target returning `false`.
+        struct all_of {
+            typedef bool result_type;
+
+            inline all_of() : m_value(true) { }
+
+            inline bool operator()(bool value) { m_value = value; return m_value; }
+            inline void merge(all_of const& o) { m_value = (m_value && o.m_value); }
+            inline all_of neutral() const { return all_of(); }
+
+            inline result_type result() const { return m_value; }
+
+        private:
+            bool m_value;
+        };
+
+        /// `true` if any called target returned `true`; stops at the first target
+        /// returning `true`.
+        struct any_of {
+            typedef bool result_type;
+
+            inline any_of() : m_value(false) { }
+
+            inline bool operator()(bool value) { m_value = value; return !m_value; }
+            inline void merge(any_of const& o) { m_value = (m_value || o.m_value); }
+            inline any_of neutral() const { return any_of(); }
+
+            inline result_type result() const { return m_value; }
+
+        private:
+            bool m_value;
+        };
+
+        /// Folds all return values into an accumulator starting with `init`:
+        /// `acc = op(std::move(acc), value)`. Use `make_fold()` for creating it. For a
+        /// parallel fold `op` also gets called with two accumulators, and each chunk of
+        /// targets starts with `identity` (by default `T()`), which needs to be the
+        /// neutral element of `op` (e.g., `1` for a product); `init` counts only once.
+        template<typename T, typename OP>
+        struct fold {
+            typedef T result_type;
+
+            inline fold(T init, OP op, T identity = T()) : m_value(std::move(init)), m_identity(std::move(identity)), m_op(std::move(op)) { }
+
+            template<typename V>
+            inline void operator()(V&& value) { m_value = m_op(std::move(m_value), std::forward<V>(value)); }
+            inline void merge(fold const& o) { m_value = m_op(std::move(m_value), o.m_value); }
+            inline fold neutral() const { return fold(m_identity, m_op, m_identity); }
+
+            inline result_type result() const { return m_value; }
+
+        private:
+            T  m_value;
+            T  m_identity;
+            OP m_op;
+        };
+
+        template<typename T, typename OP>
+        inline fold<T, OP> make_fold(T init, OP op) { return fold<T, OP>(std::move(init), std::move(op)); }
+
+        template<typename T, typename OP>
+        inline fold<T, OP> make_fold(T init, OP op, T identity) { return fold<T, OP>(std::move(init), std::move(op), std::move(identity)); }
+
+    } // namespace combiners
+
+} // namespace signals
@@ -29,13 +29,26 @@
 #  define SIGNALS_CPP_NOEXCEPT noexcept
 #endif // defined(_MSC_VER) && (_MSC_VER < 1900)
 
+#if defined(_MSC_VER) && (_MSC_VER < 1900)
+#  define SIGNALS_CPP_CONSTEXPR
+#else // defined(_MSC_VER) && (_MSC_VER < 1900)
+#  define SIGNALS_CPP_CONSTEXPR constexpr
+#endif // defined(_MSC_VER) && (_MSC_VER < 1900)
+
 #if defined(_MSC_VER) && (_MSC_VER < 1900)
 #  define SIGNALS_CPP_NEED_EXPLICIT_MOVE
 #endif // defined(_MSC_VER) && (_MSC_VER < 1900)
 
-#if defined(__clang__) || (defined(_MSC_VER) && (_MSC_VER >= 1900))
+#if defined(__clang__) || defined(__GNUC__) || (defined(_MSC_VER) && (_MSC_VER >= 1900))
 #  define SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES
 #endif
 
+#if defined(_MSC_VER) && (_MSC_VER < 1900)
+#  define SIGNALS_CPP_THREAD_LOCAL __declspec(thread)
+#else // defined(_MSC_VER) && (_MSC_VER < 1900)
+#  define SIGNALS_CPP_THREAD_LOCAL thread_local
+#  define SIGNALS_CPP_HAVE_THREAD_LOCAL_DESTRUCTORS
+#endif // defined(_MSC_VER) && (_MSC_VER < 1900)
+
 namespace signals { }
 namespace sigs = signals;
@@ -24,10 +24,12 @@
 #pragma once
 
 #include <atomic>
-#include <memory>
+#include <chrono>
 #include <thread>
+#include <utility>
 
 #include "config.hpp"
+#include "detail/parking.hpp"
 
 namespace signals {
 
@@ -36,19 +38,124 @@ namespace signals {
     /// It can be checked if the connection is still connected and it could be
     /// disconnected.
     struct connection {
+        /// The state of a connection is kept in a single atomic word: the lowest bit
+        /// holds the `connected` flag, the next bit signals parked waiters, the third one
+        /// marks a `grace_data` block, and the remaining bits count the currently active
+        /// calls routed through this
+        /// connection. Since entering a call and disconnecting both are read-modify-write
+        /// operations on the same atomic, its modification order alone decides whether a
+        /// call started before or after a `disconnect()`; no sequentially consistent
+        /// ordering is needed.
+        ///
+        /// The `data` block is reference counted intrusively and is usually the base of
+        /// a slot node of a `signal` which also holds the target callback, so that the
+        /// state and the callback share a single allocation; `destroy` deletes that node.
         struct data {
-            inline data() : connected(true), running(0) { }
+            enum : unsigned {
+                connected_flag = 1u, // connection still active?
+                waiting_flag   = 2u, // some thread is parked until no call is running anymore
+                grace_flag     = 4u, // calls are not counted, waiting goes through a `grace_data` hook
+                running_one    = 8u  // increment for each active call routed through this connection
+            };
 
-            std::atomic<bool> connected;    // connection still active?
-            std::atomic<int>  running;      // number of currently active calls routed through this connection
+            inline SIGNALS_CPP_CONSTEXPR explicit data(void (*destroy_func)(data*), unsigned initial_state = connected_flag) :
+                state(initial_state), refs(0), blocks(0), destroy(destroy_func)
+            { }
+
+            inline void add_ref() { refs.fetch_add(1, std::memory_order_relaxed); }
+            inline void release() {
+                if((refs.fetch_sub(1, std::memory_order_acq_rel) == 1) && destroy) { destroy(this); }
+            }
+
+            inline bool connected() const { return ((state.load(std::memory_order_acquire) & connected_flag) != 0); }
+            inline unsigned running() const { return (state.load(std::memory_order_acquire) / running_one); }
+            inline bool blocked() const { return (blocks.load(std::memory_order_relaxed) != 0); }
+            inline bool idle() const {
+                auto s = state.load(std::memory_order_acquire);
+                return (!(s & grace_flag) && (s < running_one));
+            }
+
+            /// Blocks until no call is running through this connection anymore. Spins
+            /// briefly first (most calls are short), then parks the thread on the state
+            /// word, so waiting for a slow call does not burn a core. `spins` counts the
+            /// spin and yield rounds already spent, so a group of connections can share
+            /// a single spin budget.
+            inline void wait_until_idle(unsigned& spins) {
+                if(state.load(std::memory_order_relaxed) & grace_flag) {
+                    auto g = static_cast<grace_data*>(this);
+                    g->wait_for_readers(g);
+                    return;
+                }
+
+                for(; spins < 64; ++spins) {
+                    if(running() == 0) { return; }
+                }
+                for(; spins < 72; ++spins) {
+                    if(running() == 0) { return; }
+                    std::this_thread::yield();
+                }
+
+                for(;;) {
+                    auto s = state.load(std::memory_order_acquire);
+                    if(s < running_one) { return; }
+
+                    if(!(s & waiting_flag)) {
+                        if(!state.compare_exchange_weak(s, s | waiting_flag, std::memory_order_acquire)) { continue; }
+                        s |= waiting_flag;
+                    }
+                    detail::park(&state, s);
+                }
+            }
+            inline void wait_until_idle() { unsigned spins = 0; wait_until_idle(spins); }
+
+            /// Called on leaving a call: only the last running call wakes up parked
+            /// waiters, and only if there are any; the common case is a single RMW.
+            inline void leave() {
+                auto prev = state.fetch_sub(running_one, std::memory_order_release);
+                if((prev & waiting_flag) && (prev < 2 * running_one)) {
+                    state.fetch_and(~unsigned(waiting_flag), std::memory_order_relaxed);
+                    detail::unpark_all(&state);
+                }
+            }
+
+            std::atomic<unsigned> state;
+            std::atomic<unsigned> refs;             // number of `connection` handles referencing this block
+            std::atomic<unsigned> blocks;           // number of `shared_connection_block`s blocking the calls
+            void                (*destroy)(data*);  // deletes the enclosing node; `nullptr` if not owned by the handles
+
+        private:
+            data(data const& o); // = delete;
+            data& operator=(data const& o); // = delete;
+        };
+
+        /// The `data` block of a connection whose calls do not get counted as running
+        /// (e.g., the ones of a `realtime_signal`, which must not touch any shared state
+        /// per call): waiting for running calls (e.g., via `disconnect(true)`) calls the
+        /// `wait_for_readers` hook instead, which waits for a grace period of the signal.
+        struct grace_data : data {
+            inline grace_data(void (*destroy_func)(data*), void (*wait_func)(grace_data*)) :
+                data(destroy_func, connected_flag | grace_flag), wait_for_readers(wait_func)
+            { }
+
+            void (*wait_for_readers)(grace_data*);
         };
 
     public:
-        inline connection() { }
-        inline connection(std::shared_ptr<data> d) : m_data(std::move(d)) { }
+        inline connection() : m_data(nullptr) { }
+        inline explicit connection(data* d) : m_data(d) { if(m_data) { m_data->add_ref(); } }
+        inline ~connection() { if(m_data) { m_data->release(); } }
+
+        inline connection(connection const& o) : m_data(o.m_data) { if(m_data) { m_data->add_ref(); } }
+        inline connection(connection&& o) SIGNALS_CPP_NOEXCEPT : m_data(o.m_data) { o.m_data = nullptr; }
+
+        inline connection& operator=(connection o) SIGNALS_CPP_NOEXCEPT { std::swap(m_data, o.m_data); return *this; }
 
         /// Checks if the `connection` represented by this object is (still) connected.
-        inline bool connected() const { return (m_data && m_data->connected); }
+        inline bool connected() const { return (m_data && m_data->connected()); }
+
+        /// Checks if the calls of this `connection` are currently blocked by some
+        /// `shared_connection_block`.
+        inline bool blocked() const { return (m_data && m_data->blocked()); }
 
         /// Disconnects this `connection`. After the `disconnect` call the corresponding
         /// target callback will not be triggered anymore. If there are currently some
@@ -58,36 +165,114 @@ namespace signals {
             auto d = m_data;
             if(!d) { return false; }
 
-            const bool was_connected = d->connected.exchange(false);
+            const auto prev = d->state.fetch_and(~unsigned(data::connected_flag), std::memory_order_acq_rel);
 
             if(wait_if_running) {
-                while(d->running > 0) {
-                    std::this_thread::yield();
-                }
+                d->wait_until_idle();
             }
 
-            return was_connected;
+            return ((prev & data::connected_flag) != 0);
         }
 
     public:
-        // only for internal use
+        // only for internal use; the caller has to keep this `connection` object
+        // alive during the call (e.g., via the targets snapshot of the `signal`),
+        // so the `data` block gets borrowed without touching its reference count;
+        // returns `false` if the `connection` was not connected (anymore); a blocked
+        // call is skipped, but the connection still counts as connected
         template<typename CB>
-        inline void call(CB&& cb) {
+        inline bool call(CB&& cb) const {
             auto d = m_data;
-            if(!d || !d->connected) { return; }
+            if(!d || !(d->state.load(std::memory_order_relaxed) & data::connected_flag)) { return false; }
+            if(d->blocked()) { return true; }
+
+            // announce the call and re-check the `connected` flag in a single step;
+            // the acquire prevents the call from being hoisted above this point
+            call_scope scope(d);
+            if(!(scope.prev_state & data::connected_flag)) { return false; }
 
-            ++d->running;
-            if(d->connected) { cb(); }
-            --d->running;
+            cb();
+            return true;
         }
 
+        // only for internal use; like `call()`, but for signals used by a single thread
+        // only (see `threading::single_threaded`): the call is not announced, so it
+        // costs just a plain load of the `connected` flag
+        template<typename CB>
+        inline bool call_unsynchronized(CB&& cb) const {
+            auto d = m_data;
+            if(!d || !(d->state.load(std::memory_order_relaxed) & data::connected_flag)) { return false; }
+            if(d->blocked()) { return true; }
+
+            cb();
+            return true;
+        }
+
+        // only for internal use; announces a call which gets executed later (e.g., on
+        // another thread), so `disconnect(true)` waits for it as well; returns `false`
+        // if not connected (anymore) or blocked, otherwise `leave()` needs to be called
+        // exactly once after the call has been executed (or dropped)
+        inline bool enter() const {
+            auto d = m_data;
+            if(!d || d->blocked()) { return false; }
+
+            const auto prev = d->state.fetch_add(data::running_one, std::memory_order_acquire);
+            if(prev & data::connected_flag) { return true; }
+
+            d->leave();
+            return false;
+        }
+
+        // only for internal use; see `enter()`
+        inline void leave() const { m_data->leave(); }
+
         // only for internal use
-        inline static connection make_connection() {
-            return connection(std::make_shared<data>());
+        inline data* get() const { return m_data; }
+
+        // only for internal use; waits until no call is running anymore through any
+        // of the already disconnected connections in the range [`first`, `last`)
+        // (`get_data` maps an element to its `data` block) and returns the time spent
+        // waiting. Since a disconnected connection does not start any new calls it
+        // is sufficient to scan the range once, and the spin budget is shared by all
+        // connections, so only the first busy one spins before the thread parks.
+        template<typename ITER, typename GET_DATA>
+        inline static std::chrono::steady_clock::duration wait_until_idle(ITER first, ITER last, GET_DATA get_data) {
+            std::chrono::steady_clock::time_point start;
+            bool waited = false;
+            unsigned spins = 0;
+
+            for(; first != last; ++first) {
+                auto d = get_data(*first);
+                if(!d || d->idle()) { continue; }
+
+                if(!waited) { start = std::chrono::steady_clock::now(); waited = true; }
+                d->wait_until_idle(spins);
+            }
+
+            return (waited ? (std::chrono::steady_clock::now() - start) : std::chrono::steady_clock::duration::zero());
         }
 
     private:
-        std::shared_ptr<data> m_data;
+        /// Leaves the call (with release semantics, so a waiting `disconnect(true)`
+        /// sees all effects of the call) even if the target throws an exception.
+        struct call_scope {
+            inline explicit call_scope(data* d) :
+                m_data(d), prev_state(d->state.fetch_add(data::running_one, std::memory_order_acquire))
+            { }
+            inline ~call_scope() { m_data->leave(); }
+
+        private:
+            data* m_data;
+
+        public:
+            const unsigned prev_state;
+
+        private:
+            call_scope(call_scope const& o); // = delete;
+            call_scope& operator=(call_scope const& o); // = delete;
+        };
+
+        data* m_data;
     };
 
 } // namespace signals
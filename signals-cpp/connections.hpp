@@ -23,6 +23,10 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -41,9 +45,27 @@ namespace signals {
     /// connects itself to other signals. The `connections` member should therefore be best
     /// placed at the end of the class members of that class, so it gets destructed before
     /// all other members which ensures that all other data members are still available and
-    /// valid to finish potential callback running in parallel on other threads. The 
+    /// valid to finish potential callback running in parallel on other threads.
+    ///
+    /// All methods can be called from several threads concurrently. The `add`, `track`
+    /// and `track_many` methods return an `id` for each tracked `connection`, which
+    /// disconnects (or untracks) that single connection in O(1). Freed slots get reused
+    /// via an intrusive free list. Connections which got disconnected elsewhere are
+    /// pruned automatically while adding new ones.
     struct connections {
-        inline connections()  { }
+        /// Identifies a `connection` tracked by a `connections` object (see `add`); an
+        /// `id` becomes invalid once its connection got removed or pruned.
+        struct id {
+            inline id() : index(0), generation(0) { }
+            inline id(std::size_t i, std::size_t g) : index(i), generation(g) { }
+
+            inline bool valid() const { return (generation != 0); }
+
+            std::size_t index;
+            std::size_t generation;
+        };
+
+        inline connections() : m_free(npos), m_size(0), m_prune_at(min_prune_at) { }
         inline ~connections() { disconnect_all(true); }
 
 #if defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
@@ -57,6 +79,13 @@ namespace signals {
             return conn;
         }
 
+        /// Connects to the given `signal` `s` like `connect()`, but returns the `id`
+        /// of the tracked `connection` for removing it again in O(1) (see `disconnect(id)`).
+        template<typename SIGNAL, typename... ARGS>
+        inline id track(SIGNAL& s, ARGS&&... args) {
+            return add(s.connect(std::forward<ARGS>(args)...));
+        }
+
 #else //  defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
 
         template<typename SIGNAL, typename ARG1>
@@ -65,6 +94,10 @@ namespace signals {
             add(conn);
             return conn;
         }
+        template<typename SIGNAL, typename ARG1>
+        inline id track(SIGNAL& s, ARG1&& arg1) {
+            return add(s.connect(std::forward<ARG1>(arg1)));
+        }
 
         template<typename SIGNAL, typename ARG1, typename ARG2>
         inline connection connect(SIGNAL& s, ARG1&& arg1, ARG2&& arg2) {
@@ -72,6 +105,10 @@ namespace signals {
             add(conn);
             return conn;
         }
+        template<typename SIGNAL, typename ARG1, typename ARG2>
+        inline id track(SIGNAL& s, ARG1&& arg1, ARG2&& arg2) {
+            return add(s.connect(std::forward<ARG1>(arg1), std::forward<ARG2>(arg2)));
+        }
 
         template<typename SIGNAL, typename ARG1, typename ARG2, typename ARG3>
         inline connection connect(SIGNAL& s, ARG1&& arg1, ARG2&& arg2, ARG3&& arg3) {
@@ -79,6 +116,10 @@ namespace signals {
             add(conn);
             return conn;
         }
+        template<typename SIGNAL, typename ARG1, typename ARG2, typename ARG3>
+        inline id track(SIGNAL& s, ARG1&& arg1, ARG2&& arg2, ARG3&& arg3) {
+            return add(s.connect(std::forward<ARG1>(arg1), std::forward<ARG2>(arg2), std::forward<ARG3>(arg3)));
+        }
 
         template<typename SIGNAL, typename ARG1, typename ARG2, typename ARG3, typename ARG4>
         inline connection connect(SIGNAL& s, ARG1&& arg1, ARG2&& arg2, ARG3&& arg3, ARG4&& arg4) {
@@ -86,6 +127,10 @@ namespace signals {
             add(conn);
             return conn;
         }
+        template<typename SIGNAL, typename ARG1, typename ARG2, typename ARG3, typename ARG4>
+        inline id track(SIGNAL& s, ARG1&& arg1, ARG2&& arg2, ARG3&& arg3, ARG4&& arg4) {
+            return add(s.connect(std::forward<ARG1>(arg1), std::forward<ARG2>(arg2), std::forward<ARG3>(arg3), std::forward<ARG4>(arg4)));
+        }
 
         template<typename SIGNAL, typename ARG1, typename ARG2, typename ARG3, typename ARG4, typename ARG5>
         inline connection connect(SIGNAL& s, ARG1&& arg1, ARG2&& arg2, ARG3&& arg3, ARG4&& arg4, ARG5&& arg5) {
@@ -93,6 +138,10 @@ namespace signals {
             add(conn);
             return conn;
         }
+        template<typename SIGNAL, typename ARG1, typename ARG2, typename ARG3, typename ARG4, typename ARG5>
+        inline id track(SIGNAL& s, ARG1&& arg1, ARG2&& arg2, ARG3&& arg3, ARG4&& arg4, ARG5&& arg5) {
+            return add(s.connect(std::forward<ARG1>(arg1), std::forward<ARG2>(arg2), std::forward<ARG3>(arg3), std::forward<ARG4>(arg4), std::forward<ARG5>(arg5)));
+        }
 
         template<typename SIGNAL, typename ARG1, typename ARG2, typename ARG3, typename ARG4, typename ARG5, typename ARG6>
         inline connection connect(SIGNAL& s, ARG1&& arg1, ARG2&& arg2, ARG3&& arg3, ARG4&& arg4, ARG5&& arg5, ARG6&& arg6) {
@@ -100,28 +149,139 @@ namespace signals {
             add(conn);
             return conn;
         }
+        template<typename SIGNAL, typename ARG1, typename ARG2, typename ARG3, typename ARG4, typename ARG5, typename ARG6>
+        inline id track(SIGNAL& s, ARG1&& arg1, ARG2&& arg2, ARG3&& arg3, ARG4&& arg4, ARG5&& arg5, ARG6&& arg6) {
+            return add(s.connect(std::forward<ARG1>(arg1), std::forward<ARG2>(arg2), std::forward<ARG3>(arg3), std::forward<ARG4>(arg4), std::forward<ARG5>(arg5), std::forward<ARG6>(arg6)));
+        }
 
 #endif //  defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
 
-        /// If the given `connection` `conn` is connected it gets added to the list of
-        /// tracked connections.
-        inline void add(connection conn) {
-            if(conn.connected()) {
-                m_conns.emplace_back(std::move(conn));
+        /// Connects all targets of the range [`first`, `last`) to the given `signal` `s`
+        /// at once (see `signal::connect_all`) and adds the created connections to the
+        /// list of tracked connections.
+        template<typename SIGNAL, typename ITER>
+        inline std::vector<connection> connect_many(SIGNAL& s, ITER first, ITER last) {
+            auto conns = s.connect_all(first, last);
+            std::vector<connection> dead;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for(auto&& c : conns) { add_locked(c, dead); }
+            }
+            return conns;
+        }
+
+        /// Connects all targets of the given `range` to the given `signal` `s` at once.
+        template<typename SIGNAL, typename RANGE>
+        inline std::vector<connection> connect_many(SIGNAL& s, RANGE const& range) {
+            return connect_many(s, std::begin(range), std::end(range));
+        }
+
+        /// Connects all targets of the range [`first`, `last`) like `connect_many()`, but
+        /// returns the `id`s of the tracked connections (in the same order).
+        template<typename SIGNAL, typename ITER>
+        inline std::vector<id> track_many(SIGNAL& s, ITER first, ITER last) {
+            auto conns = s.connect_all(first, last);
+            std::vector<id> ids;
+            ids.reserve(conns.size());
+            std::vector<connection> dead;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for(auto&& c : conns) { ids.push_back(add_locked(std::move(c), dead)); }
             }
+            return ids;
+        }
+
+        /// Connects all targets of the given `range` like `connect_many()`, but returns
+        /// the `id`s of the tracked connections.
+        template<typename SIGNAL, typename RANGE>
+        inline std::vector<id> track_many(SIGNAL& s, RANGE const& range) {
+            return track_many(s, std::begin(range), std::end(range));
+        }
+
+        /// If the given `connection` `conn` is connected it gets added to the list of
+        /// tracked connections; returns the `id` for removing it again (or an invalid
+        /// `id` if `conn` was not connected).
+        inline id add(connection conn) {
+            if(!conn.connected()) { return id(); }
+
+            std::vector<connection> dead; // released after unlocking (may destroy targets)
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return add_locked(std::move(conn), dead);
+        }
+
+        /// Stops tracking the `connection` identified by `conn_id` without disconnecting
+        /// it; returns that `connection` (or an empty one if `conn_id` is not valid anymore).
+        inline connection remove(id const& conn_id) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if(!owns_locked(conn_id)) { return connection(); }
+
+            connection conn(std::move(m_slots[conn_id.index].conn));
+            free_locked(conn_id.index);
+            return conn;
+        }
+
+        /// Disconnects the `connection` identified by `conn_id` and stops tracking it
+        /// (see `connection::disconnect` for `wait_if_running`); returns `false` if
+        /// `conn_id` is not valid anymore or the `connection` was already disconnected.
+        inline bool disconnect(id const& conn_id, bool wait_if_running = false) {
+            return remove(conn_id).disconnect(wait_if_running);
+        }
+
+        /// Stops tracking all connections which are not connected anymore; returns
+        /// the number of pruned connections.
+        inline std::size_t prune() {
+            std::vector<connection> dead;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            prune_locked(dead);
+            return dead.size();
+        }
+
+        /// Returns the number of tracked connections (including the ones which got
+        /// disconnected elsewhere but have not been pruned yet).
+        inline std::size_t size() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_size;
         }
 
-        /// Disconnects all tracked `connections`.
-        inline void disconnect_all(bool wait_if_running = false) {
-            for(auto&& i : m_conns) { i.disconnect(false); } // first disconnect all connections without waiting
-            if(wait_if_running) { for(auto&& i : m_conns) { i.disconnect(true); } } // then wait for them (if requested)
-            m_conns.clear();
+        /// Disconnects all tracked `connections`. If `wait_if_running` is set, it blocks
+        /// until no call is running anymore through any of these connections; returns the
+        /// total time spent waiting.
+        inline std::chrono::steady_clock::duration disconnect_all(bool wait_if_running = false) {
+            std::vector<connection> conns;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                conns.reserve(m_size);
+                for(std::size_t i = 0; i < m_slots.size(); ++i) {
+                    if(m_slots[i].conn.get()) {
+                        conns.push_back(std::move(m_slots[i].conn));
+                        free_locked(i);
+                    }
+                }
+                m_prune_at = min_prune_at;
+            }
+
+            // disconnect outside of the lock, so running targets can still use this object
+            for(auto&& i : conns) { i.disconnect(false); } // first disconnect all connections without waiting
+
+            auto waited = std::chrono::steady_clock::duration::zero();
+            if(wait_if_running) { // then wait for all of them at once (if requested)
+                waited = connection::wait_until_idle(conns.begin(), conns.end(), [](connection const& c) { return c.get(); });
+            }
+
+            return waited;
         }
 
 #if defined(SIGNALS_CPP_NEED_EXPLICIT_MOVE)
     public:
-        inline connections(connections&& o) : m_conns(std::move(o.m_conns)) { }
-        inline connections& operator=(connections&& o) { m_conns = std::move(o.m_conns); return *this; }
+        inline connections(connections&& o) : m_free(npos), m_size(0), m_prune_at(min_prune_at) { *this = std::move(o); }
+        inline connections& operator=(connections&& o) {
+            std::lock(m_mutex, o.m_mutex);
+            std::lock_guard<std::mutex> lock1(m_mutex, std::adopt_lock);
+            std::lock_guard<std::mutex> lock2(o.m_mutex, std::adopt_lock);
+            m_slots = std::move(o.m_slots); m_free = o.m_free; m_size = o.m_size; m_prune_at = o.m_prune_at;
+            o.m_slots.clear(); o.m_free = npos; o.m_size = 0; o.m_prune_at = min_prune_at;
+            return *this;
+        }
 #endif // defined(SIGNALS_CPP_NEED_EXPLICIT_MOVE)
 
     private:
@@ -129,7 +289,69 @@ namespace signals {
         connections& operator=(connections const& o); // = delete;
 
     private:
-        std::vector<connection> m_conns;
+        enum : std::size_t { npos = ~std::size_t(0), min_prune_at = 16 };
+
+        /// A tracked `connection`, or a link in the free list if `conn` is empty.
+        struct slot {
+            inline explicit slot(connection c) : conn(std::move(c)), generation(1), next_free(npos) { }
+
+            connection  conn;
+            std::size_t generation; // bumped on freeing the slot, which invalidates its `id`
+            std::size_t next_free;
+        };
+
+        inline id add_locked(connection conn, std::vector<connection>& dead) {
+            // before growing, prune the connections which got disconnected elsewhere; the
+            // next prune happens after the number of slots doubled, so adding stays O(1)
+            // amortized and the slots are bound by twice the number of live connections
+            if((m_free == npos) && (m_slots.size() >= m_prune_at)) {
+                prune_locked(dead);
+                m_prune_at = (2 * m_size < min_prune_at ? min_prune_at : 2 * m_size);
+            }
+
+            std::size_t index = m_free;
+            if(index != npos) {
+                m_free = m_slots[index].next_free;
+                m_slots[index].conn = std::move(conn);
+            } else {
+                index = m_slots.size();
+                m_slots.emplace_back(std::move(conn));
+            }
+
+            ++m_size;
+            return id(index, m_slots[index].generation);
+        }
+
+        inline bool owns_locked(id const& conn_id) const {
+            return (conn_id.valid() && (conn_id.index < m_slots.size()) &&
+                (m_slots[conn_id.index].generation == conn_id.generation) && m_slots[conn_id.index].conn.get());
+        }
+
+        // the slot's `conn` needs to be moved out already
+        inline void free_locked(std::size_t index) {
+            auto& s = m_slots[index];
+            if(++s.generation == 0) { s.generation = 1; } // `0` marks an invalid `id`
+            s.next_free = m_free;
+            m_free = index;
+            --m_size;
+        }
+
+        inline void prune_locked(std::vector<connection>& dead) {
+            for(std::size_t i = 0; i < m_slots.size(); ++i) {
+                auto& s = m_slots[i];
+                if(s.conn.get() && !s.conn.connected()) {
+                    dead.push_back(std::move(s.conn));
+                    free_locked(i);
+                }
+            }
+        }
+
+    private:
+        mutable std::mutex  m_mutex;
+        std::vector<slot>   m_slots;
+        std::size_t         m_free;     // head of the free list of `m_slots`
+        std::size_t         m_size;     // number of tracked connections
+        std::size_t         m_prune_at; // number of slots triggering the next prune
     };
 
 } // namespace signals
@@ -0,0 +1,164 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "config.hpp"
+
+#if defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
+
+namespace signals {
+
+    template<typename SIGNATURE>
+    struct delegate;
+
+    /// The `delegate` class is a non-owning, trivially copyable callback consisting of
+    /// just an object pointer and a pointer to a stub function which is instantiated
+    /// for a method known at compile-time. Calling a `delegate` results in a single
+    /// indirect call with the method call itself being inlined into the stub; the
+    /// arguments get forwarded without any intermediate copies. A `delegate` can also
+    /// be used as the `TARGET` type of a `signal`, e.g.:
+    ///
+    ///     signals::signal<void(int), signals::delegate<void(int)>> sig;
+    ///     sig.connect<Foo, &Foo::onValue>(&foo);
+    template<typename R, typename... ARGS>
+    struct delegate<R(ARGS...)> {
+        inline delegate() SIGNALS_CPP_NOEXCEPT : m_obj(nullptr), m_stub(nullptr) { }
+        inline delegate(std::nullptr_t) SIGNALS_CPP_NOEXCEPT : m_obj(nullptr), m_stub(nullptr) { }
+
+        /// Creates a `delegate` calling the method `METHOD` on the object `obj`.
+        template<typename OBJ, R (OBJ::*METHOD)(ARGS...)>
+        inline static delegate bind(OBJ* obj) {
+            assert(obj);
+            return delegate(obj, &method_stub<OBJ, METHOD>);
+        }
+
+        /// Creates a `delegate` calling the const method `METHOD` on the object `obj`.
+        template<typename OBJ, R (OBJ::*METHOD)(ARGS...) const>
+        inline static delegate bind(OBJ const* obj) {
+            assert(obj);
+            return delegate(const_cast<OBJ*>(obj), &const_method_stub<OBJ, METHOD>);
+        }
+
+        /// Creates a `delegate` calling the free-standing function `FUNC`.
+        template<R (*FUNC)(ARGS...)>
+        inline static delegate bind() {
+            return delegate(nullptr, &function_stub<FUNC>);
+        }
+
+        inline explicit operator bool() const SIGNALS_CPP_NOEXCEPT { return (m_stub != nullptr); }
+
+        inline R operator()(ARGS... args) const {
+            assert(m_stub);
+            return m_stub(m_obj, std::forward<ARGS>(args)...);
+        }
+
+        inline bool operator==(delegate const& o) const { return ((m_obj == o.m_obj) && (m_stub == o.m_stub)); }
+        inline bool operator!=(delegate const& o) const { return !(*this == o); }
+
+    private:
+        typedef R (*stub)(void* obj, ARGS&&... args);
+
+        inline delegate(void* obj, stub s) : m_obj(obj), m_stub(s) { }
+
+        template<typename OBJ, R (OBJ::*METHOD)(ARGS...)>
+        inline static R method_stub(void* obj, ARGS&&... args) {
+            return (static_cast<OBJ*>(obj)->*METHOD)(std::forward<ARGS>(args)...);
+        }
+
+        template<typename OBJ, R (OBJ::*METHOD)(ARGS...) const>
+        inline static R const_method_stub(void* obj, ARGS&&... args) {
+            return (static_cast<OBJ const*>(obj)->*METHOD)(std::forward<ARGS>(args)...);
+        }
+
+        template<R (*FUNC)(ARGS...)>
+        inline static R function_stub(void*, ARGS&&... args) {
+            return FUNC(std::forward<ARGS>(args)...);
+        }
+
+        void* m_obj;
+        stub  m_stub;
+    };
+
+    namespace detail {
+
+        template<typename OBJ, typename SIGNATURE>
+        struct method_pointer;
+
+        template<typename OBJ, typename R, typename... ARGS>
+        struct method_pointer<OBJ, R(ARGS...)> {
+            typedef R (OBJ::*type)(ARGS...);
+            typedef R (OBJ::*const_type)(ARGS...) const;
+        };
+
+        /// Calls the method `METHOD` known at compile-time on the object `obj` with
+        /// perfectly forwarded arguments.
+        template<typename OBJ, typename METHOD_TYPE, METHOD_TYPE METHOD>
+        struct static_method {
+            template<typename... A>
+            inline auto operator()(A&&... a) const -> decltype((std::declval<OBJ*>()->*METHOD)(std::forward<A>(a)...)) {
+                return (obj->*METHOD)(std::forward<A>(a)...);
+            }
+
+            OBJ* obj;
+        };
+
+        /// Calls the method `method` given at runtime on the object `obj` with
+        /// perfectly forwarded arguments.
+        template<typename OBJ, typename METHOD_TYPE>
+        struct bound_method {
+            template<typename... A>
+            inline auto operator()(A&&... a) const -> decltype((std::declval<OBJ*>()->*std::declval<METHOD_TYPE>())(std::forward<A>(a)...)) {
+                return (obj->*method)(std::forward<A>(a)...);
+            }
+
+            OBJ*        obj;
+            METHOD_TYPE method;
+        };
+
+        /// Creates the `TARGET` for calling the method `METHOD` known at compile-time on `obj`.
+        template<typename TARGET, typename SIGNATURE, typename OBJ, typename METHOD_TYPE, METHOD_TYPE METHOD>
+        struct method_target {
+            inline static TARGET make(OBJ* obj) {
+                static_method<OBJ, METHOD_TYPE, METHOD> m = { obj };
+                return TARGET(m);
+            }
+        };
+
+        template<typename SIGNATURE, typename OBJ, typename METHOD_TYPE, METHOD_TYPE METHOD>
+        struct method_target<delegate<SIGNATURE>, SIGNATURE, OBJ, METHOD_TYPE, METHOD> {
+            inline static delegate<SIGNATURE> make(OBJ* obj) {
+                return delegate<SIGNATURE>::template bind<typename std::remove_const<OBJ>::type, METHOD>(obj);
+            }
+        };
+
+    } // namespace detail
+
+} // namespace signals
+
+#endif // defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
@@ -0,0 +1,68 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include <memory>
+#include <new>
+
+#include "../config.hpp"
+
+namespace signals {
+    namespace detail {
+
+        /// Rebinds the allocator type `A` to the value type `T`.
+        template<typename A, typename T>
+        struct rebind_alloc {
+#if defined(_MSC_VER) && (_MSC_VER < 1900)
+            typedef typename A::template rebind<T>::other type;
+#else // defined(_MSC_VER) && (_MSC_VER < 1900)
+            typedef typename std::allocator_traits<A>::template rebind_alloc<T> type;
+#endif // defined(_MSC_VER) && (_MSC_VER < 1900)
+        };
+
+        /// Releases the memory allocated for a single `T` object via `alloc` if the
+        /// construction of the object throws an exception.
+        template<typename A>
+        struct allocation_guard {
+            typedef typename A::value_type value_type;
+
+            inline explicit allocation_guard(A& alloc) : m_alloc(alloc), ptr(alloc.allocate(1)) { }
+            inline ~allocation_guard() { if(ptr) { m_alloc.deallocate(ptr, 1); } }
+
+            /// Gives up the ownership of the memory (after successfully constructing the object).
+            inline value_type* release() { auto p = ptr; ptr = nullptr; return p; }
+
+        private:
+            A& m_alloc;
+
+        public:
+            value_type* ptr;
+
+        private:
+            allocation_guard(allocation_guard const& o); // = delete;
+            allocation_guard& operator=(allocation_guard const& o); // = delete;
+        };
+
+    } // namespace detail
+} // namespace signals
@@ -0,0 +1,67 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+#include "../config.hpp"
+
+#if defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
+
+namespace signals {
+    namespace detail {
+
+        template<std::size_t... INDICES>
+        struct index_sequence { };
+
+        template<std::size_t N, std::size_t... INDICES>
+        struct make_index_sequence : make_index_sequence<N - 1, N - 1, INDICES...> { };
+
+        template<std::size_t... INDICES>
+        struct make_index_sequence<0, INDICES...> { typedef index_sequence<INDICES...> type; };
+
+        template<typename F, typename TUPLE, std::size_t... INDICES>
+        inline void apply_impl(F&& f, TUPLE& args, index_sequence<INDICES...>) {
+            f(std::get<INDICES>(args)...);
+        }
+
+        /// Calls `f` with the elements of the tuple `args` passed as lvalues (the
+        /// same stored arguments might be passed on to several targets).
+        template<typename F, typename... ARGS>
+        inline void apply(F&& f, std::tuple<ARGS...>& args) {
+            apply_impl(std::forward<F>(f), args, typename make_index_sequence<sizeof...(ARGS)>::type());
+        }
+
+        /// Calls `f` with the elements of the tuple `args` passed as const lvalues.
+        template<typename F, typename... ARGS>
+        inline void apply(F&& f, std::tuple<ARGS...> const& args) {
+            apply_impl(std::forward<F>(f), args, typename make_index_sequence<sizeof...(ARGS)>::type());
+        }
+
+    } // namespace detail
+} // namespace signals
+
+#endif // defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
@@ -0,0 +1,233 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include "../config.hpp"
+
+namespace signals {
+    namespace detail {
+
+        /// A minimal epoch based reclamation (EBR) domain. Readers announce the global
+        /// epoch they started in via a per-thread record (no shared cache line gets
+        /// written on the read path) and writers `retire()` objects they unlinked.
+        /// A retired object gets deleted as soon as no reader is active anymore in an
+        /// epoch that could still reference it. The read path never blocks: leaving a
+        /// read section attempts a reclaim only if the global epoch advanced since the
+        /// last one or after every `reclaim_interval` leaves of the thread, and that
+        /// attempt gives up immediately if another thread is reclaiming already.
+        struct epoch_domain {
+            enum { reclaim_interval = 64 };
+
+            struct thread_record {
+                inline thread_record() : epoch(0), in_use(true), next(nullptr), nesting(0), leaves(0) { }
+
+                std::atomic<std::uint64_t> epoch;   // epoch of the active reader; 0 if inactive
+                std::atomic<bool>          in_use;  // record claimed by a thread?
+                thread_record*             next;    // immutable after publishing
+                unsigned                   nesting; // only accessed by the owning thread
+                unsigned                   leaves;  // only accessed by the owning thread
+            };
+
+            inline epoch_domain() :
+                m_global_epoch(1), m_scanned_epoch(0), m_records(nullptr), m_retired_count(0), m_pending_count(0), m_reclaiming(false)
+            { }
+
+            inline ~epoch_domain() {
+                // no reader can be active anymore at this point
+                for(auto&& i : m_retired) { i.deleter(i.ptr); }
+                for(auto&& i : m_pending) { i.deleter(i.ptr); }
+
+                auto r = m_records.load();
+                while(r) { auto n = r->next; delete r; r = n; }
+            }
+
+            /// Claims a free `thread_record` or creates a new one.
+            inline thread_record* acquire_record() {
+                for(auto r = m_records.load(std::memory_order_acquire); r; r = r->next) {
+                    bool expected = false;
+                    if(!r->in_use.load(std::memory_order_relaxed) && r->in_use.compare_exchange_strong(expected, true)) {
+                        return r;
+                    }
+                }
+
+                auto r = new thread_record();
+                r->next = m_records.load(std::memory_order_relaxed);
+                while(!m_records.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed)) { }
+                return r;
+            }
+
+            /// Gives a `thread_record` back for reuse by other threads.
+            inline void release_record(thread_record* r) {
+                r->in_use.store(false, std::memory_order_release);
+            }
+
+            inline void enter(thread_record* r) {
+                if(r->nesting++ == 0) {
+                    // publish the epoch before reading any shared pointer: an RMW instead of a
+                    // store plus fence, so it is ordered against the RMW of the scan in
+                    // `try_reclaim()` on the same record (which the thread sanitizer checks, too)
+                    r->epoch.exchange(m_global_epoch.load(std::memory_order_acquire), std::memory_order_seq_cst);
+                }
+            }
+
+            inline void leave(thread_record* r) {
+                if(--r->nesting == 0) {
+                    r->epoch.store(0, std::memory_order_release);
+                    if((m_retired_count.load(std::memory_order_relaxed) + m_pending_count.load(std::memory_order_relaxed)) == 0) { return; }
+                    if((++r->leaves % reclaim_interval == 0) ||
+                        (m_global_epoch.load(std::memory_order_relaxed) != m_scanned_epoch.load(std::memory_order_relaxed)))
+                    {
+                        try_reclaim();
+                    }
+                }
+            }
+
+            /// Hands the already unlinked object `ptr` over to the domain; it will be
+            /// deleted via `deleter` once no reader can reference it anymore.
+            inline void retire(void* ptr, void (*deleter)(void*)) {
+                {
+                    std::lock_guard<std::mutex> lock(m_retired_mutex);
+                    retired r = { ptr, deleter, m_global_epoch.fetch_add(1, std::memory_order_acq_rel) };
+                    m_retired.push_back(r);
+                    m_retired_count.store(m_retired.size(), std::memory_order_relaxed);
+                }
+                try_reclaim();
+            }
+
+            /// Deletes all retired objects which are not reachable by any active reader
+            /// anymore. Never blocks: if another thread is currently reclaiming this call
+            /// is a no-op, and newly retired objects only get picked up if the mutex of
+            /// the retired list is free (otherwise with the next call).
+            inline void try_reclaim() {
+                if(m_reclaiming.exchange(true, std::memory_order_acquire)) { return; }
+
+                // move the newly retired objects over to the ones only the reclaiming
+                // thread accesses; both buffers keep their capacity, so retiring and
+                // reclaiming do not allocate in the steady state
+                {
+                    std::unique_lock<std::mutex> lock(m_retired_mutex, std::try_to_lock);
+                    if(lock && !m_retired.empty()) {
+                        m_pending.insert(m_pending.end(), m_retired.begin(), m_retired.end());
+                        m_retired.clear();
+                        m_retired_count.store(0, std::memory_order_relaxed);
+                    }
+                }
+                m_scanned_epoch.store(m_global_epoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+
+                if(!m_pending.empty()) {
+                    // each record gets read via an RMW, which is ordered against the RMW
+                    // in `enter()`: either the scan sees the reader's epoch, or the reader
+                    // synchronizes with the scan and is guaranteed to see the new state
+                    auto min_active = std::numeric_limits<std::uint64_t>::max();
+                    for(auto r = m_records.load(std::memory_order_acquire); r; r = r->next) {
+                        auto e = r->epoch.fetch_add(0, std::memory_order_seq_cst); // pairs with `enter()` and the release in `leave()`
+                        if(e != 0 && e < min_active) { min_active = e; }
+                    }
+
+                    // delete the unreachable objects and compact the remaining ones in place
+                    std::size_t kept = 0;
+                    for(std::size_t i = 0, iEnd = m_pending.size(); i < iEnd; ++i) {
+                        if(m_pending[i].epoch < min_active) { m_pending[i].deleter(m_pending[i].ptr); } else { m_pending[kept++] = m_pending[i]; }
+                    }
+                    m_pending.resize(kept);
+                }
+                m_pending_count.store(m_pending.size(), std::memory_order_relaxed);
+
+                m_reclaiming.store(false, std::memory_order_release);
+            }
+
+            inline static epoch_domain& instance() {
+                static epoch_domain domain;
+                return domain;
+            }
+
+        private:
+            struct retired {
+                void*         ptr;
+                void        (*deleter)(void*);
+                std::uint64_t epoch;
+            };
+
+            std::atomic<std::uint64_t>  m_global_epoch;
+            std::atomic<std::uint64_t>  m_scanned_epoch;    // global epoch at the last reclaim
+            std::atomic<thread_record*> m_records;
+            std::atomic<std::size_t>    m_retired_count;
+            std::atomic<std::size_t>    m_pending_count;
+            std::atomic<bool>           m_reclaiming;       // owns `m_pending`
+            std::mutex                  m_retired_mutex;    // only taken on the write path
+            std::vector<retired>        m_retired;          // retired, not yet seen by a reclaim
+            std::vector<retired>        m_pending;          // retired, still reachable by readers
+
+        private:
+            epoch_domain(epoch_domain const& o); // = delete;
+            epoch_domain& operator=(epoch_domain const& o); // = delete;
+        };
+
+#if defined(SIGNALS_CPP_HAVE_THREAD_LOCAL_DESTRUCTORS)
+        /// Gives the `thread_record` of the current thread back to the domain on thread exit.
+        struct epoch_thread_exit {
+            inline epoch_thread_exit() : slot(nullptr) { }
+            inline ~epoch_thread_exit() {
+                if(slot && *slot) { epoch_domain::instance().release_record(*slot); *slot = nullptr; }
+            }
+
+            epoch_domain::thread_record** slot;
+        };
+#endif // defined(SIGNALS_CPP_HAVE_THREAD_LOCAL_DESTRUCTORS)
+
+        /// Returns the `thread_record` of the calling thread in the global domain.
+        inline epoch_domain::thread_record* epoch_thread_record() {
+            static SIGNALS_CPP_THREAD_LOCAL epoch_domain::thread_record* t_record = nullptr;
+            if(!t_record) {
+                t_record = epoch_domain::instance().acquire_record();
+#if defined(SIGNALS_CPP_HAVE_THREAD_LOCAL_DESTRUCTORS)
+                static SIGNALS_CPP_THREAD_LOCAL epoch_thread_exit t_exit;
+                t_exit.slot = &t_record;
+#endif // defined(SIGNALS_CPP_HAVE_THREAD_LOCAL_DESTRUCTORS)
+            }
+            return t_record;
+        }
+
+        /// RAII helper marking the calling thread as an active reader of the global
+        /// `epoch_domain` for its lifetime; guards can be nested.
+        struct epoch_guard {
+            inline epoch_guard() : m_record(epoch_thread_record()) { epoch_domain::instance().enter(m_record); }
+            inline ~epoch_guard() { epoch_domain::instance().leave(m_record); }
+
+        private:
+            epoch_domain::thread_record* m_record;
+
+        private:
+            epoch_guard(epoch_guard const& o); // = delete;
+            epoch_guard& operator=(epoch_guard const& o); // = delete;
+        };
+
+    } // namespace detail
+} // namespace signals
@@ -0,0 +1,124 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+#include "../config.hpp"
+#include "allocation.hpp"
+
+namespace signals {
+    namespace detail {
+
+        template<typename T>
+        struct mpmc_ring_cell {
+            std::atomic<std::size_t> sequence;
+            T                        value;
+        };
+
+        /// A bounded lock-free multi-producer/multi-consumer queue of trivially copyable
+        /// values (D. Vyukov's design): each cell carries a sequence number telling the
+        /// producers and consumers whether it is free for writing or ready for reading
+        /// in the current lap, so there is no ABA problem and neither side ever blocks.
+        /// The cells get allocated via (a rebound copy of) the given `ALLOCATOR`.
+        template<typename T, typename ALLOCATOR = std::allocator<T>>
+        struct mpmc_ring : private rebind_alloc<ALLOCATOR, mpmc_ring_cell<T>>::type { // (empty) allocator as base for EBO
+            typedef mpmc_ring_cell<T>                                       cell;
+            typedef typename rebind_alloc<ALLOCATOR, cell>::type            cell_allocator;
+
+            inline explicit mpmc_ring(std::size_t capacity, ALLOCATOR const& alloc = ALLOCATOR()) :
+                cell_allocator(alloc), m_cells(nullptr), m_mask(capacity - 1), m_enqueue_pos(0), m_dequeue_pos(0)
+            {
+                assert((capacity >= 2) && ((capacity & (capacity - 1)) == 0)); // power of two
+                m_cells = cell_allocator::allocate(capacity);
+                for(std::size_t i = 0; i < capacity; ++i) {
+                    ::new(static_cast<void*>(&m_cells[i])) cell();
+                    m_cells[i].sequence.store(i, std::memory_order_relaxed);
+                }
+            }
+
+            inline ~mpmc_ring() {
+                for(std::size_t i = 0; i <= m_mask; ++i) { m_cells[i].~cell(); }
+                cell_allocator::deallocate(m_cells, m_mask + 1);
+            }
+
+            /// Returns `false` if the ring is full.
+            inline bool try_push(T value) {
+                auto pos = m_enqueue_pos.load(std::memory_order_relaxed);
+                for(;;) {
+                    auto& c = m_cells[pos & m_mask];
+                    auto seq = c.sequence.load(std::memory_order_acquire);
+                    auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+                    if(diff == 0) {
+                        if(m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                            c.value = value;
+                            c.sequence.store(pos + 1, std::memory_order_release);
+                            return true;
+                        }
+                    } else if(diff < 0) {
+                        return false;
+                    } else {
+                        pos = m_enqueue_pos.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            /// Returns `false` if the ring is empty.
+            inline bool try_pop(T& value) {
+                auto pos = m_dequeue_pos.load(std::memory_order_relaxed);
+                for(;;) {
+                    auto& c = m_cells[pos & m_mask];
+                    auto seq = c.sequence.load(std::memory_order_acquire);
+                    auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+                    if(diff == 0) {
+                        if(m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                            value = c.value;
+                            c.sequence.store(pos + m_mask + 1, std::memory_order_release);
+                            return true;
+                        }
+                    } else if(diff < 0) {
+                        return false;
+                    } else {
+                        pos = m_dequeue_pos.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+        private:
+            cell*                    m_cells;
+            const std::size_t        m_mask;
+            std::atomic<std::size_t> m_enqueue_pos;
+            std::atomic<std::size_t> m_dequeue_pos;
+
+        private:
+            mpmc_ring(mpmc_ring const& o); // = delete;
+            mpmc_ring& operator=(mpmc_ring const& o); // = delete;
+        };
+
+    } // namespace detail
+} // namespace signals
@@ -0,0 +1,94 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#if defined(__linux__)
+#  include <climits>
+#  include <linux/futex.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif // defined(__linux__)
+
+#include "../config.hpp"
+
+namespace signals {
+    namespace detail {
+
+#if defined(__linux__)
+
+        // on Linux the waiting thread gets parked directly on the atomic word via a futex
+
+        /// Blocks the calling thread as long as `*addr == expected`; might return spuriously.
+        inline void park(std::atomic<unsigned>* addr, unsigned expected) {
+            static_assert(sizeof(std::atomic<unsigned>) == sizeof(int), "futex requires a 32-bit word");
+            syscall(SYS_futex, reinterpret_cast<int*>(addr), FUTEX_WAIT_PRIVATE, static_cast<int>(expected), nullptr, nullptr, 0);
+        }
+
+        /// Wakes up all threads parked on `addr`.
+        inline void unpark_all(std::atomic<unsigned>* addr) {
+            syscall(SYS_futex, reinterpret_cast<int*>(addr), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+        }
+
+#else // defined(__linux__)
+
+        // everywhere else the waiting thread gets parked on a condition variable in
+        // a small table of buckets which is indexed by the address of the atomic word
+
+        struct parking_lot {
+            struct bucket {
+                std::mutex              mutex;
+                std::condition_variable cond;
+            };
+
+            inline static bucket& bucket_for(void const* addr) {
+                static bucket buckets[64];
+                auto a = reinterpret_cast<std::uintptr_t>(addr);
+                return buckets[(a >> 4) % 64];
+            }
+        };
+
+        /// Blocks the calling thread as long as `*addr == expected`; might return spuriously.
+        inline void park(std::atomic<unsigned>* addr, unsigned expected) {
+            auto& b = parking_lot::bucket_for(addr);
+            std::unique_lock<std::mutex> lock(b.mutex);
+            if(addr->load(std::memory_order_acquire) == expected) { b.cond.wait(lock); }
+        }
+
+        /// Wakes up all threads parked on `addr`.
+        inline void unpark_all(std::atomic<unsigned>* addr) {
+            auto& b = parking_lot::bucket_for(addr);
+            { std::lock_guard<std::mutex> lock(b.mutex); } // a parking thread is either not yet checking or already waiting
+            b.cond.notify_all();
+        }
+
+#endif // defined(__linux__)
+
+    } // namespace detail
+} // namespace signals
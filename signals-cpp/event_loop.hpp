@@ -0,0 +1,342 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "config.hpp"
+#include "connection.hpp"
+#include "detail/allocation.hpp"
+#include "detail/apply.hpp"
+#include "detail/mpmc_ring.hpp"
+#include "detail/parking.hpp"
+
+namespace signals {
+
+    /// The `event_loop` class executes events posted from any thread on the single
+    /// thread calling `run()`, `run_one()` or `poll()`. It is the target of queued
+    /// connections (see `signal::connect(event_loop&, target)`), which deliver each
+    /// `fire()` as an event to the loop instead of calling the target inline.
+    ///
+    /// The events are kept in an intrusive lock-free MPSC queue (D. Vyukov's design):
+    /// posting an event is a single atomic exchange and never blocks on the consumer;
+    /// the consumer thread only gets woken up if it is actually sleeping. The queue
+    /// gets drained in batches.
+    ///
+    /// The `event_loop` has to outlive all queued connections targeting it. Events
+    /// still pending on destruction get discarded without being executed.
+    struct event_loop {
+        /// The intrusive base of all events; `run` executes the event (or only
+        /// disposes it if `execute` is `false`) and releases its memory.
+        struct event {
+            std::atomic<event*> next;
+            void              (*run)(event* e, bool execute);
+        };
+
+        inline event_loop() : m_head(&m_stub), m_tail(&m_stub), m_sleeping(0), m_stopped(false) {
+            m_stub.next.store(nullptr, std::memory_order_relaxed);
+            m_stub.run = nullptr;
+        }
+
+        inline ~event_loop() {
+            while(auto e = pop()) { e->run(e, false); }
+        }
+
+        /// Posts the event `e`; can be called from any thread.
+        inline void post(event* e) {
+            e->next.store(nullptr, std::memory_order_relaxed);
+            auto prev = m_head.exchange(e, std::memory_order_seq_cst); // pairs with the check in `wait()`
+            prev->next.store(e, std::memory_order_release);
+            wake_up();
+        }
+
+        /// Posts the task `t`, so the `event_loop` can also serve as an executor for
+        /// `signal::post()`; in contrast to queued connections this allocates an event.
+        inline void post(std::function<void()> t) { post(new task_event(std::move(t))); }
+
+        /// Executes all events available at the time of the call (but does not wait
+        /// for any events); returns the number of executed events.
+        inline std::size_t poll() {
+            std::size_t count = 0;
+            while(auto e = pop()) { e->run(e, true); ++count; }
+            return count;
+        }
+
+        /// Executes a single event; waits for one if none is available. Returns
+        /// `false` without executing an event if the loop got stopped.
+        inline bool run_one() {
+            for(;;) {
+                if(auto e = pop()) { e->run(e, true); return true; }
+                if(m_stopped.load(std::memory_order_acquire)) { return false; }
+                wait();
+            }
+        }
+
+        /// Executes events in batches until `stop()` gets called.
+        inline void run() {
+            while(!m_stopped.load(std::memory_order_acquire)) {
+                if(poll() == 0) { wait(); }
+            }
+        }
+
+        /// Makes `run()` and `run_one()` return; can be called from any thread.
+        inline void stop() {
+            m_stopped.store(true, std::memory_order_release);
+            wake_up(true);
+        }
+
+        inline void restart() { m_stopped.store(false, std::memory_order_release); }
+        inline bool stopped() const { return m_stopped.load(std::memory_order_acquire); }
+
+    private:
+        struct task_event : event {
+            inline explicit task_event(std::function<void()> t) : task(std::move(t)) { run = &run_task; }
+
+            inline static void run_task(event* e, bool execute) {
+                std::unique_ptr<task_event> self(static_cast<task_event*>(e));
+                if(execute) { self->task(); }
+            }
+
+            std::function<void()> task;
+        };
+
+        /// Only called by the consumer thread; returns `nullptr` if no event is
+        /// available (or a producer has not finished linking its event yet).
+        inline event* pop() {
+            auto tail = m_tail;
+            auto next = tail->next.load(std::memory_order_acquire);
+
+            if(tail == &m_stub) {
+                if(!next) { return nullptr; }
+                m_tail = next;
+                tail = next;
+                next = next->next.load(std::memory_order_acquire);
+            }
+
+            if(next) {
+                m_tail = next;
+                return tail;
+            }
+
+            if(tail != m_head.load(std::memory_order_acquire)) { return nullptr; } // a producer is in the middle of `post()`
+
+            // `tail` is the last event: put the stub behind it, so it can be handed out
+            post_stub();
+            next = tail->next.load(std::memory_order_acquire);
+            if(next) {
+                m_tail = next;
+                return tail;
+            }
+            return nullptr;
+        }
+
+        inline void post_stub() {
+            m_stub.next.store(nullptr, std::memory_order_relaxed);
+            auto prev = m_head.exchange(&m_stub, std::memory_order_acq_rel);
+            prev->next.store(&m_stub, std::memory_order_release);
+        }
+
+        inline bool empty() const {
+            return ((m_tail->next.load(std::memory_order_acquire) == nullptr) && (m_head.load(std::memory_order_seq_cst) == m_tail));
+        }
+
+        /// Parks the consumer thread until an event gets posted (or `stop()` gets called).
+        inline void wait() {
+            for(int i = 0; i < 64; ++i) {
+                if(!empty() || m_stopped.load(std::memory_order_acquire)) { return; }
+                std::this_thread::yield();
+            }
+
+            // announce the sleep before the final check: either the producer sees the
+            // announcement in `wake_up()` or this thread sees its event in `empty()`
+            m_sleeping.store(1, std::memory_order_seq_cst);
+            if(empty() && !m_stopped.load(std::memory_order_seq_cst)) { detail::park(&m_sleeping, 1); }
+            m_sleeping.store(0, std::memory_order_relaxed);
+        }
+
+        inline void wake_up(bool force = false) {
+            if(force || (m_sleeping.load(std::memory_order_seq_cst) != 0)) {
+                m_sleeping.store(0, std::memory_order_relaxed);
+                detail::unpark_all(&m_sleeping);
+            }
+        }
+
+        std::atomic<event*>   m_head;     // producers push here
+        event*                m_tail;     // consumer pops here
+        event                 m_stub;
+        std::atomic<unsigned> m_sleeping; // consumer is (about to be) parked
+        std::atomic<bool>     m_stopped;
+
+    private:
+        event_loop(event_loop const& o); // = delete;
+        event_loop& operator=(event_loop const& o); // = delete;
+    };
+
+#if defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
+
+    namespace detail {
+
+        template<typename SIGNATURE>
+        struct signature_args;
+
+        template<typename R, typename... ARGS>
+        struct signature_args<R(ARGS...)> {
+            typedef R                                               result_type;
+            typedef std::tuple<typename std::decay<ARGS>::type...>  args_tuple;
+        };
+
+        /// The state of a queued connection: the actual target, the `event_loop` the
+        /// calls get delivered to, and a slab of preallocated event cells with a free
+        /// list (a lock-free ring of cell indices) of them. As long as not more than
+        /// `CELLS` events of this connection are pending, posting an event does not
+        /// allocate any memory; otherwise the event gets allocated via (a rebound copy
+        /// of) the `ALLOCATOR`, which is used for the free list as well.
+        template<typename TARGET, typename SIGNATURE, typename ALLOCATOR = std::allocator<TARGET>, std::size_t CELLS = 64>
+        struct queued_slot {
+            typedef typename signature_args<SIGNATURE>::args_tuple args_tuple;
+            static_assert(std::is_void<typename signature_args<SIGNATURE>::result_type>::value, "queued connections require a void signature");
+
+            struct cell : event_loop::event {
+                queued_slot*     owner;
+                connection       conn;  // keeps the slot node alive while the event is pending
+                std::uint32_t    index; // index within the slab; `CELLS` for heap allocated cells
+                typename std::aligned_storage<sizeof(args_tuple), std::alignment_of<args_tuple>::value>::type args;
+            };
+
+            inline queued_slot(event_loop& loop, TARGET t, ALLOCATOR const& alloc = ALLOCATOR()) :
+                target(std::move(t)), m_loop(&loop), m_data(nullptr), m_cell_alloc(alloc), m_free(CELLS, index_allocator(alloc))
+            {
+                for(std::uint32_t i = 0; i < CELLS; ++i) {
+                    m_cells[i].owner = this;
+                    m_cells[i].index = i;
+                    m_cells[i].run   = &run_cell;
+                    m_free.try_push(i);
+                }
+            }
+
+            /// Binds the slot to the state of its `connection`; needs to be called before
+            /// the connection gets published.
+            inline void attach(connection::data* d) { m_data = d; }
+
+            /// Called on the firing thread: copies the arguments into a cell and posts it.
+            template<typename... ARGS>
+            inline void enqueue(ARGS&&... args) {
+                // a pending event does not count as a running call (only its execution
+                // does), so disconnecting never waits for the loop to drain its events
+                connection conn(m_data);
+                if(!conn.connected()) { return; }
+
+                cell* c = acquire_cell();
+                try {
+                    ::new(static_cast<void*>(&c->args)) args_tuple(std::forward<ARGS>(args)...);
+                } catch(...) {
+                    release_cell(c);
+                    throw;
+                }
+                c->conn = std::move(conn);
+                m_loop->post(c);
+            }
+
+            TARGET target;
+
+        private:
+            inline cell* acquire_cell() {
+                std::uint32_t i = 0;
+                if(m_free.try_pop(i)) { return &m_cells[i]; }
+
+                detail::allocation_guard<cell_allocator> mem(m_cell_alloc);
+                auto c = ::new(static_cast<void*>(mem.ptr)) cell();
+                mem.release();
+                c->owner = this;
+                c->index = CELLS;
+                c->run   = &run_cell;
+                return c;
+            }
+
+            inline void release_cell(cell* c) {
+                if(c->index < CELLS) {
+                    m_free.try_push(c->index);
+                } else {
+                    c->~cell();
+                    m_cell_alloc.deallocate(c, 1);
+                }
+            }
+
+            /// Called on the thread of the `event_loop`.
+            inline static void run_cell(event_loop::event* e, bool execute) {
+                auto c = static_cast<cell*>(e);
+                auto owner = c->owner;
+                auto args = reinterpret_cast<args_tuple*>(&c->args);
+                connection conn(std::move(c->conn)); // released last, it might delete the owner
+
+                struct cleanup {
+                    inline ~cleanup() {
+                        args->~args_tuple();
+                        owner->release_cell(c);
+                    }
+                    queued_slot* owner; cell* c; args_tuple* args;
+                } scope = { owner, c, args };
+
+                // events of a disconnected target get dropped here
+                if(execute) { conn.call([&]() { detail::apply(owner->target, *args); }); }
+            }
+
+            typedef typename rebind_alloc<ALLOCATOR, cell>::type            cell_allocator;
+            typedef typename rebind_alloc<ALLOCATOR, std::uint32_t>::type   index_allocator;
+
+            event_loop*                                 m_loop;
+            connection::data*                           m_data;
+            cell_allocator                              m_cell_alloc;
+            mpmc_ring<std::uint32_t, index_allocator>   m_free;
+            cell                                        m_cells[CELLS];
+
+        private:
+            queued_slot(queued_slot const& o); // = delete;
+            queued_slot& operator=(queued_slot const& o); // = delete;
+        };
+
+        /// The target stored in the `signal` for a queued connection: forwards the
+        /// arguments of each call to its `queued_slot`.
+        template<typename QUEUED_SLOT>
+        struct queued_forwarder {
+            template<typename... ARGS>
+            inline void operator()(ARGS&&... args) const { slot->enqueue(std::forward<ARGS>(args)...); }
+
+            std::shared_ptr<QUEUED_SLOT> slot;
+        };
+
+    } // namespace detail
+
+#endif // defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
+
+} // namespace signals
@@ -0,0 +1,140 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "config.hpp"
+
+#if defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
+
+namespace signals {
+
+    template<typename SIGNATURE, std::size_t CAPACITY = 32, std::size_t ALIGNMENT = alignof(std::max_align_t)>
+    struct inplace_function;
+
+    /// The `inplace_function` class is a drop-in replacement for `std::function`
+    /// which stores the callable object always in place within a buffer of
+    /// `CAPACITY` bytes. It never allocates memory; trying to store a callable
+    /// object which is too large for the buffer results in a compile-time error.
+    /// It can be used as the `TARGET` type of a `signal`, e.g.:
+    ///
+    ///     signals::signal<void(int), signals::inplace_function<void(int), 64>> sig;
+    ///
+    /// so that the targets of the `signal` are stored contiguously and connecting
+    /// to a lambda expression does not touch the heap.
+    template<typename R, typename... ARGS, std::size_t CAPACITY, std::size_t ALIGNMENT>
+    struct inplace_function<R(ARGS...), CAPACITY, ALIGNMENT> {
+
+        inline inplace_function() SIGNALS_CPP_NOEXCEPT : m_invoke(nullptr), m_manage(nullptr) { }
+        inline inplace_function(std::nullptr_t) SIGNALS_CPP_NOEXCEPT : m_invoke(nullptr), m_manage(nullptr) { }
+
+        template<
+            typename FUNC,
+            typename F = typename std::decay<FUNC>::type,
+            typename = typename std::enable_if<!std::is_same<F, inplace_function>::value>::type
+        >
+        inline inplace_function(FUNC&& func) : m_invoke(nullptr), m_manage(nullptr) {
+            static_assert(sizeof(F) <= CAPACITY, "callable object too large for this inplace_function; increase its CAPACITY");
+            static_assert(ALIGNMENT % alignof(F) == 0, "callable object has a stricter alignment than this inplace_function");
+
+            if(is_null(static_cast<F const&>(func))) { return; }
+
+            ::new(static_cast<void*>(&m_storage)) F(std::forward<FUNC>(func));
+            m_invoke = &invoke<F>;
+            m_manage = &manage<F>;
+        }
+
+        inline inplace_function(inplace_function const& o) : m_invoke(o.m_invoke), m_manage(o.m_manage) {
+            if(m_manage) { m_manage(copy_op, &m_storage, const_cast<storage*>(&o.m_storage)); }
+        }
+
+        inline inplace_function(inplace_function&& o) SIGNALS_CPP_NOEXCEPT : m_invoke(nullptr), m_manage(nullptr) {
+            take(o);
+        }
+
+        inline inplace_function& operator=(inplace_function o) SIGNALS_CPP_NOEXCEPT {
+            reset();
+            take(o);
+            return *this;
+        }
+
+        inline ~inplace_function() { reset(); }
+
+        inline explicit operator bool() const SIGNALS_CPP_NOEXCEPT { return (m_invoke != nullptr); }
+
+        inline R operator()(ARGS... args) const {
+            assert(m_invoke);
+            return m_invoke(const_cast<storage*>(&m_storage), std::forward<ARGS>(args)...);
+        }
+
+    private:
+        enum operation { copy_op, move_op, destroy_op };
+
+        typedef typename std::aligned_storage<CAPACITY, ALIGNMENT>::type storage;
+
+        /// Moves the callable object of `o` into this (empty) object and leaves `o` empty.
+        inline void take(inplace_function& o) {
+            if(o.m_manage) { o.m_manage(move_op, &m_storage, &o.m_storage); }
+            m_invoke = o.m_invoke; o.m_invoke = nullptr;
+            m_manage = o.m_manage; o.m_manage = nullptr;
+        }
+
+        inline void reset() {
+            if(m_manage) { m_manage(destroy_op, &m_storage, nullptr); }
+            m_invoke = nullptr;
+            m_manage = nullptr;
+        }
+
+        template<typename F>
+        inline static R invoke(void* obj, ARGS&&... args) {
+            return (*static_cast<F*>(obj))(std::forward<ARGS>(args)...);
+        }
+
+        template<typename F>
+        inline static void manage(operation op, void* dst, void* src) {
+            switch(op) {
+                case copy_op:    ::new(dst) F(*static_cast<F const*>(src)); break;
+                case move_op:    ::new(dst) F(std::move(*static_cast<F*>(src))); static_cast<F*>(src)->~F(); break;
+                case destroy_op: static_cast<F*>(dst)->~F(); break;
+            }
+        }
+
+        template<typename F>
+        inline static bool is_null(F const&) { return false; }
+        template<typename RET, typename... PARAMS>
+        inline static bool is_null(RET (*f)(PARAMS...)) { return (f == nullptr); }
+
+        storage m_storage;
+        R     (*m_invoke)(void* obj, ARGS&&... args);
+        void  (*m_manage)(operation op, void* dst, void* src);
+    };
+
+} // namespace signals
+
+#endif // defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
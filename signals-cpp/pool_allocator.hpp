@@ -0,0 +1,223 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+
+#include "config.hpp"
+#include "detail/allocation.hpp"
+
+namespace signals {
+    namespace detail {
+
+        /// A process wide pool of fixed-size memory blocks with one free list per
+        /// size class. Each thread caches a batch of free blocks per size class, so
+        /// allocating and deallocating blocks usually neither locks nor calls into
+        /// `malloc`; only refilling or draining a thread cache locks the central free
+        /// list of that size class. Memory is never given back to the system before
+        /// the process exits.
+        struct fixed_size_pool {
+            enum : std::size_t {
+                granularity = 16,                     // block sizes are multiples of this (and aligned to it)
+                max_size    = 256,                    // larger requests are not served by the pool
+                class_count = max_size / granularity,
+                batch_size  = 32,                     // blocks moved between a thread cache and the central list at once
+                slab_size   = 64 * 1024               // bytes requested from the system at once
+            };
+
+            struct block { block* next; };
+
+            inline static std::size_t size_class(std::size_t bytes) { return ((bytes + granularity - 1) / granularity - 1); }
+
+            /// The central free list of a single size class.
+            struct central_list {
+                inline central_list() : free(nullptr) { }
+
+                std::mutex          mutex;
+                block*              free;
+            };
+
+            /// The per-thread cache of a single size class.
+            struct thread_cache {
+                block*      free;
+                std::size_t count;
+            };
+
+            /// The pool is intentionally never destroyed, since blocks might still get
+            /// deallocated during the destruction of other static objects.
+            inline static fixed_size_pool& instance() {
+                static fixed_size_pool* pool = new fixed_size_pool();
+                return *pool;
+            }
+
+            inline void* allocate(std::size_t bytes) {
+                assert(bytes > 0 && bytes <= max_size);
+                auto& cache = local_caches()[size_class(bytes)];
+                if(!cache.free) { refill(size_class(bytes), cache); }
+
+                auto b = cache.free;
+                cache.free = b->next;
+                --cache.count;
+                return b;
+            }
+
+            inline void deallocate(void* p, std::size_t bytes) {
+                assert(bytes > 0 && bytes <= max_size);
+                auto& cache = local_caches()[size_class(bytes)];
+
+                auto b = static_cast<block*>(p);
+                b->next = cache.free;
+                cache.free = b;
+                if(++cache.count >= 2 * batch_size) { drain(size_class(bytes), cache, batch_size); }
+            }
+
+            /// Gives all blocks cached by the calling thread back to the central lists.
+            inline void release_thread_cache(thread_cache* caches) {
+                for(std::size_t i = 0; i < class_count; ++i) { drain(i, caches[i], caches[i].count); }
+            }
+
+        private:
+            inline fixed_size_pool() { }
+
+            inline void refill(std::size_t cls, thread_cache& cache) {
+                auto& central = m_central[cls];
+                std::lock_guard<std::mutex> lock(central.mutex);
+
+                if(!central.free) {
+                    // carve a new slab into blocks of this size class
+                    const auto size = (cls + 1) * granularity;
+                    const auto count = slab_size / size;
+                    auto slab = static_cast<char*>(::operator new(count * size));
+                    for(std::size_t i = count; i > 0; --i) {
+                        auto b = reinterpret_cast<block*>(slab + (i - 1) * size);
+                        b->next = central.free;
+                        central.free = b;
+                    }
+                }
+
+                for(std::size_t i = 0; (i < batch_size) && central.free; ++i) {
+                    auto b = central.free;
+                    central.free = b->next;
+                    b->next = cache.free;
+                    cache.free = b;
+                    ++cache.count;
+                }
+            }
+
+            inline void drain(std::size_t cls, thread_cache& cache, std::size_t count) {
+                if(count == 0) { return; }
+
+                auto& central = m_central[cls];
+                std::lock_guard<std::mutex> lock(central.mutex);
+                for(std::size_t i = 0; (i < count) && cache.free; ++i) {
+                    auto b = cache.free;
+                    cache.free = b->next;
+                    --cache.count;
+                    b->next = central.free;
+                    central.free = b;
+                }
+            }
+
+            inline static thread_cache* local_caches();
+
+            central_list m_central[class_count];
+
+        private:
+            fixed_size_pool(fixed_size_pool const& o); // = delete;
+            fixed_size_pool& operator=(fixed_size_pool const& o); // = delete;
+        };
+
+#if defined(SIGNALS_CPP_HAVE_THREAD_LOCAL_DESTRUCTORS)
+        /// Gives the cached blocks of an exiting thread back to the pool.
+        struct fixed_size_pool_thread_exit {
+            inline fixed_size_pool_thread_exit() : caches(nullptr) { }
+            inline ~fixed_size_pool_thread_exit() { if(caches) { fixed_size_pool::instance().release_thread_cache(caches); } }
+
+            fixed_size_pool::thread_cache* caches;
+        };
+#endif // defined(SIGNALS_CPP_HAVE_THREAD_LOCAL_DESTRUCTORS)
+
+        inline fixed_size_pool::thread_cache* fixed_size_pool::local_caches() {
+            static SIGNALS_CPP_THREAD_LOCAL thread_cache t_caches[class_count]; // zero initialized
+#if defined(SIGNALS_CPP_HAVE_THREAD_LOCAL_DESTRUCTORS)
+            static SIGNALS_CPP_THREAD_LOCAL bool t_registered = false;
+            if(!t_registered) {
+                t_registered = true;
+                static SIGNALS_CPP_THREAD_LOCAL fixed_size_pool_thread_exit t_exit;
+                t_exit.caches = t_caches;
+            }
+#endif // defined(SIGNALS_CPP_HAVE_THREAD_LOCAL_DESTRUCTORS)
+            return t_caches;
+        }
+
+    } // namespace detail
+
+    /// The `pool_allocator` is a stateless allocator which serves all requests of up
+    /// to 256 bytes from a process wide pool of fixed-size blocks with thread local
+    /// caches; larger requests are forwarded to `operator new`. It is meant to be used
+    /// as the `ALLOCATOR` of a `signal`, e.g.:
+    ///
+    ///     signals::signal<void(int), signals::inplace_function<void(int), 32>, signals::pool_allocator<void>> sig;
+    ///
+    /// so that churning connections does not hit `malloc` anymore.
+    template<typename T>
+    struct pool_allocator {
+        typedef T value_type;
+
+        inline pool_allocator() SIGNALS_CPP_NOEXCEPT { }
+        template<typename U>
+        inline pool_allocator(pool_allocator<U> const&) SIGNALS_CPP_NOEXCEPT { }
+
+        template<typename U>
+        struct rebind { typedef pool_allocator<U> other; };
+
+        inline T* allocate(std::size_t n) {
+            static_assert(alignof(T) <= detail::fixed_size_pool::granularity, "over-aligned types are not supported by the pool_allocator");
+            const auto bytes = n * sizeof(T);
+            if(bytes == 0 || bytes > detail::fixed_size_pool::max_size) {
+                return static_cast<T*>(::operator new(bytes));
+            }
+            return static_cast<T*>(detail::fixed_size_pool::instance().allocate(bytes));
+        }
+
+        inline void deallocate(T* p, std::size_t n) {
+            const auto bytes = n * sizeof(T);
+            if(bytes == 0 || bytes > detail::fixed_size_pool::max_size) {
+                ::operator delete(p);
+                return;
+            }
+            detail::fixed_size_pool::instance().deallocate(p, bytes);
+        }
+
+        template<typename U>
+        inline bool operator==(pool_allocator<U> const&) const SIGNALS_CPP_NOEXCEPT { return true; }
+        template<typename U>
+        inline bool operator!=(pool_allocator<U> const&) const SIGNALS_CPP_NOEXCEPT { return false; }
+    };
+
+} // namespace signals
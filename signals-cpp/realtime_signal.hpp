@@ -0,0 +1,265 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "config.hpp"
+#include "connection.hpp"
+
+#if defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
+
+namespace signals {
+
+    /// The `realtime_signal` class can be fired from a thread with hard deadlines (e.g.,
+    /// an audio or control thread): `fire()` is wait-free, it never locks a mutex, never
+    /// allocates or deallocates any memory, never destroys a target and does not touch
+    /// any reference count. The targets are kept in a snapshot with a capacity reserved
+    /// up front, so connecting a target usually just appends it in place.
+    ///
+    /// Readers announce themselves on one of two per-signal reader counters (selected
+    /// by the current phase); a grace period flips the phase twice and waits until the
+    /// readers of the previous phases are gone. Replaced snapshots (after growing the
+    /// capacity, `collect()` or `disconnect_all()`) are never deleted by the writers
+    /// themselves, but get handed off to `reclaim()`, which is meant to be called
+    /// periodically by a non-realtime thread (and by the destructor); it waits for a
+    /// grace period and deletes them.
+    ///
+    /// `fire()` does not count the running calls per connection; instead, the connections
+    /// of a `realtime_signal` wait for a grace period of the signal whenever waiting for
+    /// running calls is requested (`connection::disconnect(true)`, a `scoped_connection`
+    /// or `connections` waiting on destruction, ...), so these wait for all `fire()` calls
+    /// which could still call the target, just as with a `signal`.
+    ///
+    /// All other methods (`connect()`, `disconnect()`, `collect()`, `reclaim()`, ...)
+    /// may allocate or block and must not be called from the realtime thread. A plain
+    /// `connection::disconnect()` may be called from the realtime thread, though, as long
+    /// as it does not drop the last handle to a target already removed by `collect()`.
+    template<typename SIGNATURE, typename TARGET = std::function<SIGNATURE>>
+    struct realtime_signal {
+        inline explicit realtime_signal(std::size_t capacity = 64) :
+            m_capacity(std::max<std::size_t>(1, capacity)), m_snapshot(nullptr), m_readers(std::make_shared<readers>())
+        {
+            m_snapshot.store(new snapshot(m_capacity), std::memory_order_release);
+        }
+
+        inline ~realtime_signal() {
+            disconnect_all();
+            reclaim();
+            delete m_snapshot.load(std::memory_order_relaxed);
+        }
+
+        /// Connects the `target`; grows the capacity (handing the old snapshot off to
+        /// `reclaim()`) only if all reserved slots are in use.
+        inline connection connect(TARGET target) {
+            assert(target);
+            auto conn = connection(new slot(std::move(target), m_readers));
+
+            std::lock_guard<std::mutex> lock(m_write_mutex);
+            auto s = m_snapshot.load(std::memory_order_relaxed);
+            if(s->items.size() == s->items.capacity()) {
+                auto grown = rebuild(s, 2 * s->items.capacity());
+                publish(grown);
+                s = grown;
+            }
+            s->append(conn);
+            return conn;
+        }
+
+        /// Disconnects the `conn` and waits until no `fire()` call which could still
+        /// call its target is running anymore (same as `conn.disconnect(true)`).
+        inline bool disconnect(connection& conn) { return conn.disconnect(true); }
+
+        /// Disconnects all targets (without waiting for running `fire()` calls).
+        inline void disconnect_all() {
+            std::lock_guard<std::mutex> lock(m_write_mutex);
+            auto s = m_snapshot.load(std::memory_order_relaxed);
+            for(auto&& i : s->items) { i.disconnect(); }
+            publish(new snapshot(m_capacity));
+        }
+
+        /// Removes the disconnected targets from the snapshot; the old snapshot gets
+        /// handed off to `reclaim()`.
+        inline void collect() {
+            std::lock_guard<std::mutex> lock(m_write_mutex);
+            auto s = m_snapshot.load(std::memory_order_relaxed);
+            if(std::any_of(s->items.begin(), s->items.end(), [](connection const& c) { return !c.connected(); })) {
+                publish(rebuild(s, s->items.capacity()));
+            }
+        }
+
+        /// Waits for a grace period and deletes all snapshots handed off so far (and
+        /// thereby releases the disconnected targets); returns the number of deleted
+        /// snapshots. Call it from a non-realtime thread.
+        inline std::size_t reclaim() {
+            std::vector<snapshot*> retired;
+            {
+                std::lock_guard<std::mutex> lock(m_write_mutex);
+                if(m_retired.empty()) { return 0; }
+                retired.swap(m_retired);
+                m_readers->synchronize();
+            }
+            for(auto s : retired) { delete s; }
+            return retired.size();
+        }
+
+        /// Returns the number of snapshots waiting for `reclaim()`.
+        inline std::size_t retired() const {
+            std::lock_guard<std::mutex> lock(m_write_mutex);
+            return m_retired.size();
+        }
+
+        /// Calls all connected targets; wait-free and safe to be called from a realtime
+        /// thread (as long as the targets are).
+        template<typename... ARGS>
+        inline void fire(ARGS&&... args) const {
+            read_scope scope(*m_readers);
+            auto s = m_snapshot.load(std::memory_order_seq_cst);
+            for(auto i = s->begin(), e = s->end(); i != e; ++i) {
+                i->call_unsynchronized([&]() { static_cast<slot const*>(i->get())->target(std::forward<ARGS>(args)...); });
+            }
+        }
+
+    private:
+        /// The reader counters of the two phases; shared with the slots, so waiting for
+        /// running calls via a `connection` works even after the signal is gone.
+        struct readers {
+            inline readers() : phase(0) {
+                count[0].store(0, std::memory_order_relaxed);
+                count[1].store(0, std::memory_order_relaxed);
+            }
+
+            /// Waits until all `fire()` calls which started before have finished. A reader
+            /// may have picked its counter just before a phase flip, so the phase gets flipped
+            /// twice, each time waiting for the readers of the phase left; new readers always
+            /// enter the current phase, so the waiting thread cannot starve.
+            inline void synchronize() {
+                std::lock_guard<std::mutex> lock(mutex);
+                for(int round = 0; round < 2; ++round) {
+                    auto prev = (phase.fetch_add(1, std::memory_order_seq_cst) & 1u);
+                    for(unsigned spins = 0; count[prev].load(std::memory_order_seq_cst) != 0; ++spins) {
+                        if(spins >= 64) { std::this_thread::yield(); }
+                    }
+                }
+            }
+
+            std::atomic<unsigned>   phase;
+            std::atomic<unsigned>   count[2];
+            std::mutex              mutex; // serializes the grace periods
+        };
+
+        struct slot : connection::grace_data {
+            inline slot(TARGET t, std::shared_ptr<readers> r) :
+                connection::grace_data(&destroy_slot, &wait_for_grace_period), target(std::move(t)), m_readers(std::move(r))
+            { }
+
+            inline static void destroy_slot(connection::data* d) { delete static_cast<slot*>(d); }
+            inline static void wait_for_grace_period(connection::grace_data* d) { static_cast<slot*>(d)->m_readers->synchronize(); }
+
+            TARGET target;
+
+        private:
+            std::shared_ptr<readers> m_readers;
+        };
+
+        /// The connections of a snapshot: `items` never grows beyond its reserved
+        /// capacity, so targets get appended in place and published via `count`.
+        struct snapshot {
+            inline explicit snapshot(std::size_t capacity) : first(nullptr), count(0) { items.reserve(capacity); first = items.data(); }
+
+            // only for writers
+            inline void append(connection const& conn) {
+                assert(items.size() < items.capacity());
+                items.push_back(conn);
+                count.store(items.size(), std::memory_order_release);
+            }
+
+            inline connection const* begin() const { return first; }
+            inline connection const* end() const { return (first + count.load(std::memory_order_acquire)); }
+
+            std::vector<connection>  items; // modified by the writers only
+            connection const*        first; // stable, since `items` never grows beyond its reserved capacity
+            std::atomic<std::size_t> count; // number of published items
+
+        private:
+            snapshot(snapshot const& o); // = delete;
+            snapshot& operator=(snapshot const& o); // = delete;
+        };
+
+        /// Announces a `fire()` call on the reader counter of the current phase.
+        struct read_scope {
+            inline explicit read_scope(readers& r) :
+                m_counter(r.count[r.phase.load(std::memory_order_seq_cst) & 1u])
+            {
+                m_counter.fetch_add(1, std::memory_order_seq_cst);
+            }
+            inline ~read_scope() { m_counter.fetch_sub(1, std::memory_order_release); }
+
+        private:
+            std::atomic<unsigned>& m_counter;
+
+        private:
+            read_scope(read_scope const& o); // = delete;
+            read_scope& operator=(read_scope const& o); // = delete;
+        };
+
+        // must be called with `m_write_mutex` locked
+        inline snapshot* rebuild(snapshot const* s, std::size_t capacity) const {
+            auto result = new snapshot(std::max(capacity, m_capacity));
+            for(auto&& i : s->items) {
+                if(i.connected()) { result->append(i); }
+            }
+            return result;
+        }
+
+        // must be called with `m_write_mutex` locked
+        inline void publish(snapshot* s) {
+            auto old = m_snapshot.exchange(s, std::memory_order_seq_cst);
+            m_retired.push_back(old);
+        }
+
+        const std::size_t               m_capacity;
+        std::atomic<snapshot*>          m_snapshot;
+        std::shared_ptr<readers>        m_readers;
+        mutable std::mutex              m_write_mutex; // serializes the writers only
+        std::vector<snapshot*>          m_retired;     // replaced snapshots waiting for `reclaim()`
+
+    private:
+        realtime_signal(realtime_signal const& o); // = delete;
+        realtime_signal& operator=(realtime_signal const& o); // = delete;
+    };
+
+} // namespace signals
+
+#endif // defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
@@ -0,0 +1,177 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+#include "config.hpp"
+#include "connection.hpp"
+
+namespace signals {
+
+    namespace detail {
+
+        /// An owning reference to a `connection::data` block plus a flag, packed into a
+        /// single pointer-sized word (the flag lives in the lowest bit, which is always
+        /// zero due to the alignment of the `data` block).
+        struct tagged_connection {
+            static_assert(alignof(connection::data) >= 2, "the lowest bit of a connection::data pointer needs to be unused");
+
+            inline tagged_connection() SIGNALS_CPP_NOEXCEPT : m_bits(0) { }
+            inline tagged_connection(connection const& conn, bool flag) : m_bits(reinterpret_cast<std::uintptr_t>(conn.get()) | (flag ? 1u : 0u)) {
+                if(auto d = get()) { d->add_ref(); }
+            }
+            inline tagged_connection(tagged_connection&& o) SIGNALS_CPP_NOEXCEPT : m_bits(o.m_bits) { o.m_bits = 0; }
+            inline ~tagged_connection() { if(auto d = get()) { d->release(); } }
+
+            inline void swap(tagged_connection& o) SIGNALS_CPP_NOEXCEPT { std::swap(m_bits, o.m_bits); }
+
+            inline connection::data* get() const { return reinterpret_cast<connection::data*>(m_bits & ~std::uintptr_t(1)); }
+            inline connection conn() const { return connection(get()); }
+
+            inline bool flag() const { return ((m_bits & 1u) != 0); }
+            inline void set_flag(bool flag) { m_bits = ((m_bits & ~std::uintptr_t(1)) | (flag ? 1u : 0u)); }
+
+        private:
+            std::uintptr_t m_bits;
+
+        private:
+            tagged_connection(tagged_connection const& o); // = delete;
+            tagged_connection& operator=(tagged_connection const& o); // = delete;
+        };
+
+    } // namespace detail
+
+    /// The `scoped_connection` class is a move-only handle which disconnects its
+    /// `connection` on destruction (or on being assigned another one); if requested
+    /// it waits for running calls of the target then (see `connection::disconnect()`).
+    /// It is as large as a single pointer, so it can be embedded into lots of small
+    /// objects instead of a full `connections` container, e.g.:
+    ///
+    ///     struct listener {
+    ///         listener(signals::signal<void(int)>& sig) : m_conn(sig.connect([this](int v) { on_value(v); }), true) { }
+    ///         void on_value(int v);
+    ///         signals::scoped_connection m_conn; // the last member: disconnects and waits first
+    ///     };
+    struct scoped_connection {
+        inline scoped_connection() SIGNALS_CPP_NOEXCEPT { }
+        inline scoped_connection(connection const& conn, bool wait_on_destruction = false) : m_conn(conn, wait_on_destruction) { }
+        inline ~scoped_connection() { disconnect(); }
+
+        inline scoped_connection(scoped_connection&& o) SIGNALS_CPP_NOEXCEPT : m_conn(std::move(o.m_conn)) { }
+        inline scoped_connection& operator=(scoped_connection&& o) {
+            scoped_connection tmp(std::move(o));
+            tmp.m_conn.swap(m_conn); // the previous connection gets disconnected by `tmp`
+            return *this;
+        }
+
+        /// Checks if the `connection` represented by this object is (still) connected.
+        inline bool connected() const { return (m_conn.get() && m_conn.get()->connected()); }
+
+        /// Returns `true` if the destruction waits for running calls of the target.
+        inline bool wait_on_destruction() const { return m_conn.flag(); }
+
+        /// Disconnects the `connection` (waiting for running calls if requested on
+        /// construction) and resets this object.
+        inline bool disconnect() {
+            if(!m_conn.get()) { return false; }
+
+            detail::tagged_connection tmp;
+            tmp.swap(m_conn);
+            return tmp.conn().disconnect(tmp.flag());
+        }
+
+        /// Returns the `connection` and resets this object without disconnecting it.
+        inline connection release() {
+            detail::tagged_connection tmp;
+            tmp.swap(m_conn);
+            return tmp.conn();
+        }
+
+        /// Returns a copy of the `connection` handle.
+        inline connection get() const { return m_conn.conn(); }
+
+    private:
+        detail::tagged_connection m_conn;
+
+    private:
+        scoped_connection(scoped_connection const& o); // = delete;
+        scoped_connection& operator=(scoped_connection const& o); // = delete;
+    };
+
+    /// The `shared_connection_block` class blocks the calls of a `connection` for its
+    /// lifetime (or until `unblock()` gets called): the target does not get called
+    /// while at least one block on its connection is active, but it stays connected.
+    /// It is as large as a single pointer as well. Blocking does not wait for calls
+    /// which are already running.
+    struct shared_connection_block {
+        inline shared_connection_block() SIGNALS_CPP_NOEXCEPT { }
+        inline explicit shared_connection_block(connection const& conn, bool initially_blocking = true) : m_conn(conn, false) {
+            if(initially_blocking) { block(); }
+        }
+        inline ~shared_connection_block() { unblock(); }
+
+        inline shared_connection_block(shared_connection_block&& o) SIGNALS_CPP_NOEXCEPT : m_conn(std::move(o.m_conn)) { }
+        inline shared_connection_block& operator=(shared_connection_block&& o) {
+            shared_connection_block tmp(std::move(o));
+            tmp.m_conn.swap(m_conn); // the previous block gets released by `tmp`
+            return *this;
+        }
+
+        /// Blocks the calls of the `connection` (if not blocked by this object already).
+        inline void block() {
+            auto d = m_conn.get();
+            if(d && !m_conn.flag()) {
+                d->blocks.fetch_add(1, std::memory_order_relaxed);
+                m_conn.set_flag(true);
+            }
+        }
+
+        /// Releases the block of this object; the calls stay blocked while other blocks
+        /// on the same `connection` are active.
+        inline void unblock() {
+            auto d = m_conn.get();
+            if(d && m_conn.flag()) {
+                d->blocks.fetch_sub(1, std::memory_order_relaxed);
+                m_conn.set_flag(false);
+            }
+        }
+
+        /// Returns `true` if this object currently blocks the `connection`.
+        inline bool blocking() const { return m_conn.flag(); }
+
+        /// Returns a copy of the `connection` handle.
+        inline connection get() const { return m_conn.conn(); }
+
+    private:
+        detail::tagged_connection m_conn;
+
+    private:
+        shared_connection_block(shared_connection_block const& o); // = delete;
+        shared_connection_block& operator=(shared_connection_block const& o); // = delete;
+    };
+
+} // namespace signals
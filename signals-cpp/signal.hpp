@@ -24,61 +24,190 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <exception>
 #include <functional>
+#include <initializer_list>
+#include <iterator>
 #include <memory>
 #include <mutex>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
+#include "combiners.hpp"
 #include "connections.hpp"
+#include "delegate.hpp"
+#include "event_loop.hpp"
+#include "span.hpp"
+#include "thread_pool.hpp"
+#include "threading.hpp"
+#include "throttle.hpp"
+#include "detail/allocation.hpp"
+#include "detail/apply.hpp"
+#include "detail/epoch.hpp"
+#include "detail/parking.hpp"
 
 namespace signals {
 
-    template<typename SIGNATURE>
+    /// The `signal` class represents a source of events with the signature `SIGNATURE`
+    /// to which target callbacks (slots) can be connected. The `TARGET` type is used for
+    /// storing the connected callbacks; it defaults to `std::function<SIGNATURE>`, but
+    /// e.g. an `inplace_function<SIGNATURE, CAPACITY>` can be used for avoiding any heap
+    /// allocation for storing the callbacks. All internal memory (the slot nodes and the
+    /// targets snapshots) is obtained from the `ALLOCATOR` (rebound as needed), e.g. a
+    /// `pool_allocator<void>`.
+    template<
+        typename SIGNATURE,
+        typename TARGET = std::function<SIGNATURE>,
+        typename ALLOCATOR = std::allocator<void>,
+        typename THREADING = threading::mutex
+    >
     struct signal {
+        typedef typename THREADING::mutex_type mutex_type;
 
-        inline signal()  { }
+    private:
+        typedef detail::threading_traits<(THREADING::concurrent != 0)> threading_traits;
+        typedef typename threading_traits::read_scope read_scope;
+
+    public:
+
+#if defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
+
+        /// The argument tuples of a batch of events passed to `fire_batch()`.
+        typedef typename detail::signature_args<SIGNATURE>::args_tuple   args_tuple;
+        typedef span<args_tuple const>                                    batch_span;
+        typedef std::function<void(batch_span batch)>                     batch_target;
+
+#endif // defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
+
+        inline signal() : m_allocator(), m_targets(nullptr), m_compaction_requested(false) {
+            detail::epoch_domain::instance(); // ensure the domain outlives static `signal` instances
+        }
+        inline explicit signal(ALLOCATOR const& alloc) : m_allocator(alloc), m_targets(nullptr), m_compaction_requested(false) {
+            detail::epoch_domain::instance(); // ensure the domain outlives static `signal` instances
+        }
         inline ~signal() { disconnect_all(true); }
 
-        inline connection connect(std::function<SIGNATURE> target) {
+        inline connection connect(TARGET target) { return connect(0, std::move(target)); }
+
+        /// Connects the `target` with the given `priority` (or group): targets with a higher
+        /// priority get called before targets with a lower priority, targets with the same
+        /// priority in the order they got connected. The default priority is `0`.
+        inline connection connect(int priority, TARGET target) {
             assert(target);
 
-            // create the new conection handle
-            auto conn = connection::make_connection();
+            // create the new slot node (connection state and target in a single allocation)
+            auto conn = connection(slot_node::create(std::move(target), m_allocator));
+            insert_targets(&conn, &conn + 1, priority);
+            return conn;
+        }
 
-            // create a new targets vector (will be filled in with
-            // the existing and still active targets within the lock below)
-            auto new_targets = std::make_shared<std::vector<connection_target>>();
+#if defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
 
-            // lock the mutex for writing
-            std::lock_guard<std::mutex> lock(m_write_targets_mutex);
+        /// Connects the `target` as a queued connection: firing the signal does not call
+        /// the `target` inline but copies the arguments into an event which gets posted to
+        /// the given `event_loop` and the `target` gets called on the thread running that
+        /// loop. The firing thread never blocks on the loop, and as long as the backlog of
+        /// the connection stays small no memory gets allocated per event. Events still
+        /// pending on disconnecting get dropped, `disconnect(true)` only waits for an event
+        /// already executing on the loop's thread; so the `signal` can even be destroyed on
+        /// that thread before the loop drained its events. Requires a `void` signature.
+        inline connection connect(event_loop& loop, TARGET target) {
+            assert(target);
+            typedef detail::queued_slot<TARGET, SIGNATURE, ALLOCATOR> queued;
+            typedef typename detail::rebind_alloc<ALLOCATOR, queued>::type queued_allocator;
 
-            // copy existing targets
-            if(auto t = m_targets) {
-                new_targets->reserve(t->size() + 1);
-                for(const auto& i : *t) {
-                    if(i.conn.connected()) {
-                        new_targets->push_back(i);
-                    }
-                }
-            }
+            auto slot = std::allocate_shared<queued>(queued_allocator(m_allocator), loop, std::move(target), m_allocator);
+            detail::queued_forwarder<queued> forwarder = { slot };
 
-            // add the new connection to the new vector
-            new_targets->emplace_back(conn, std::move(target));
+            auto conn = connection(slot_node::create(TARGET(std::move(forwarder)), m_allocator));
+            slot->attach(conn.get());
+            insert_targets(&conn, &conn + 1, 0);
+            return conn;
+        }
+
+        /// Connects the `target` with a rate limit: it gets called at most at the rate
+        /// given by the `limit` (see `throttle`), further calls get dropped and counted
+        /// in the `limit`'s counters. Requires a `void` signature.
+        inline connection connect(throttle const& limit, TARGET target) {
+            assert(target);
+            static_assert(std::is_void<typename detail::signature_args<SIGNATURE>::result_type>::value, "throttled connections require a void signature");
 
-            // replace the pointer to the targets (in a thread safe manner)
-            m_targets = new_targets;
+            auto conn = connection(throttled_slot_node::create(limit, std::move(target), m_allocator));
+            insert_targets(&conn, &conn + 1, 0);
+            return conn;
+        }
+
+        /// Connects a batch-aware `target`: `fire_batch()` passes the whole batch to it
+        /// in a single call, while a plain `fire()` passes a batch with a single argument
+        /// tuple. Requires a `void` signature.
+        inline connection connect_batch(batch_target target) {
+            assert(target);
+            static_assert(std::is_void<typename detail::signature_args<SIGNATURE>::result_type>::value, "batch targets require a void signature");
 
+            auto conn = connection(batch_slot_node::create(std::move(target), m_allocator));
+            insert_targets(&conn, &conn + 1, 0);
             return conn;
         }
 
+#endif // defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
+
+        /// Connects all targets of the range [`first`, `last`) with the default priority and
+        /// returns the created connections in the same order. In contrast to calling
+        /// `connect()` for each target the write lock is taken only once, the targets
+        /// storage grows at most once and a single snapshot gets published for the whole
+        /// range.
+        template<typename ITER>
+        inline std::vector<connection> connect_all(ITER first, ITER last) {
+            // create all slot nodes upfront outside of the lock
+            std::vector<connection> conns;
+            conns.reserve(std::distance(first, last));
+            for(; first != last; ++first) {
+                TARGET target(*first);
+                assert(target);
+                conns.push_back(connection(slot_node::create(std::move(target), m_allocator)));
+            }
+
+            insert_targets(conns.begin(), conns.end(), 0);
+            return conns;
+        }
+
+        /// Connects all targets of the given `range` (see above).
+        template<typename RANGE>
+        inline std::vector<connection> connect_all(RANGE const& range) {
+            return connect_all(std::begin(range), std::end(range));
+        }
+        inline std::vector<connection> connect_all(std::initializer_list<TARGET> list) {
+            return connect_all(list.begin(), list.end());
+        }
+
 #if defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
 
         template<typename OBJ, typename... ARGS>
         inline connection connect(OBJ* obj, void (OBJ::*method)(ARGS... args)) {
             assert(obj);
             assert(method);
-            return connect([=](ARGS... args) { (obj->*method)(args...); });
+            detail::bound_method<OBJ, void (OBJ::*)(ARGS...)> target = { obj, method };
+            return connect(TARGET(target));
+        }
+
+        /// Connects to the method `METHOD` of `obj` which is known at compile-time, e.g.:
+        /// `sig.connect<Foo, &Foo::onValue>(&foo)`. The method call gets inlined into the
+        /// stored target and the arguments get forwarded without any intermediate copies.
+        template<typename OBJ, typename detail::method_pointer<OBJ, SIGNATURE>::type METHOD>
+        inline connection connect(OBJ* obj) {
+            assert(obj);
+            return connect(detail::method_target<TARGET, SIGNATURE, OBJ, typename detail::method_pointer<OBJ, SIGNATURE>::type, METHOD>::make(obj));
+        }
+
+        /// Connects to the const method `METHOD` of `obj` which is known at compile-time.
+        template<typename OBJ, typename detail::method_pointer<OBJ, SIGNATURE>::const_type METHOD>
+        inline connection connect(OBJ const* obj) {
+            assert(obj);
+            return connect(detail::method_target<TARGET, SIGNATURE, OBJ const, typename detail::method_pointer<OBJ, SIGNATURE>::const_type, METHOD>::make(obj));
         }
 
 #else // defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
@@ -127,44 +256,247 @@ namespace signals {
 
 #endif // defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
 
-        inline void disconnect_all(bool wait_if_running) {
-            auto t = decltype(m_targets)(nullptr);
+        /// Disconnects all connected targets. If `wait_if_running` is set, it blocks until
+        /// no call is running anymore through any of them; returns the total time spent
+        /// waiting.
+        inline std::chrono::steady_clock::duration disconnect_all(bool wait_if_running) {
+            auto waited = std::chrono::steady_clock::duration::zero();
+            targets* t = nullptr;
 
             {   // clean out the targets pointer so no other thread
                 // will fire this signal anymore (already running fired
                 // calls might still reference the targets)
-                std::lock_guard<std::mutex> lock(m_write_targets_mutex);
-                std::swap(m_targets, t); // replace m_targets pointer with a nullptr
+                std::lock_guard<mutex_type> lock(m_write_targets_mutex);
+                t = m_targets.exchange(nullptr, std::memory_order_acq_rel); // replace m_targets pointer with a nullptr
             }
 
-            // disconnect all targets
+            // disconnect all targets first, then wait for all of them at once (if requested)
             if(t) {
-                for(auto&& i : *t) { i.conn.disconnect(wait_if_running); }
+                for(auto g : t->groups) {
+                    for(auto&& i : g->items) { i.conn.disconnect(false); }
+                }
+                if(wait_if_running) {
+                    for(auto g : t->groups) {
+                        waited += connection::wait_until_idle(g->items.begin(), g->items.end(), [](connection_target const& i) { return i.conn.get(); });
+                    }
+                }
+                retire_targets(t, true);
+            }
+
+            return waited;
+        }
+
+        /// Drops the disconnected targets from the current snapshot, so `fire()` does
+        /// not need to visit them anymore. This happens automatically as well: once a
+        /// quarter of the targets visited by a `fire()` call were disconnected, that call
+        /// compacts the snapshot if the writer mutex is free, otherwise the next `fire()`
+        /// or `connect()` does it.
+        inline void compact() {
+            typename targets::groups_vector old_groups(m_allocator);
+            targets* old_targets = nullptr;
+
+            {
+                std::lock_guard<mutex_type> lock(m_write_targets_mutex);
+                m_compaction_requested.store(false, std::memory_order_relaxed);
+                old_targets = compact_locked(old_groups);
+            }
+
+            retire_compacted(old_targets, old_groups);
+        }
+
+        /// Returns the number of slots in the current snapshot, including disconnected
+        /// ones which did not get compacted away yet.
+        inline std::size_t slot_count() const {
+            read_scope guard(m_threading); // keeps the targets snapshot alive
+
+            std::size_t count = 0;
+            if(auto t = get_targets()) {
+                for(auto g : t->groups) { count += g->size(); }
             }
+            return count;
         }
 
 #if defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
 
+        /// Calls all connected targets with the given arguments. Firing never blocks on
+        /// the writer mutex, but once too many of the visited targets were disconnected
+        /// it try-locks it and compacts the snapshot (see `compact()`), which allocates
+        /// the new snapshot via the signal's `ALLOCATOR`.
         template<typename... ARGS>
         inline void fire_if(bool condition, ARGS&&... args) const {
             if(condition) {
-                if(auto t = get_targets()) {
-                    for(auto& i : *t) { i.conn.call([&]() { i.target(std::forward<ARGS>(args)...); }); }
-                }
+                dispatch([&](TARGET const& target) { target(std::forward<ARGS>(args)...); });
             }
         }
         template<typename... ARGS>
         inline void fire(ARGS&&... args) const { fire_if(true, std::forward<ARGS>(args)...); }
 
+        /// Fires the signal once for each argument tuple of the `batch` (e.g., a
+        /// `std::vector<args_tuple>`). The targets snapshot gets acquired only once and
+        /// each connection gets entered only once per batch: each target gets called for
+        /// all tuples (in order) before the next target gets called. Batch-aware targets
+        /// (see `connect_batch()`) receive the whole `batch` in a single call. A target
+        /// getting disconnected during the batch does not receive the remaining tuples.
+        inline void fire_batch(batch_span batch) const {
+            if(batch.empty()) { return; }
+
+            dispatch_nodes([&](slot_node const& node) {
+                if(node.connection::data::destroy == &batch_slot_node::destroy_batch_node) {
+                    static_cast<batch_slot_node const&>(node).batch(batch);
+                } else {
+                    for(auto& args : batch) {
+                        if(!node.connected()) { break; } // disconnected by one of the previous calls
+                        detail::apply(node.target, args);
+                    }
+                }
+            });
+        }
+
+        /// Fires the signal and passes the return value of each called target on to the
+        /// given `combiner` (see `combiners.hpp`), e.g., `sig.fire_collect(combiners::sum<int>(), x)`;
+        /// returns `combiner.result()`. The return values get aggregated in place and no
+        /// intermediate container gets allocated.
+        template<typename COMBINER, typename... ARGS>
+        inline typename std::decay<COMBINER>::type::result_type fire_collect(COMBINER&& combiner, ARGS&&... args) const {
+            dispatch([&](TARGET const& target) { return detail::invoke_proceed(combiner, target(std::forward<ARGS>(args)...)); });
+            return combiner.result();
+        }
+
+        /// Fires the signal asynchronously: the arguments get copied once and each connected
+        /// target gets called on a worker thread of the given `executor`, which needs to
+        /// provide a `post(std::function<void()>)` method (e.g., a `thread_pool`) and has
+        /// to execute all posted tasks eventually. The queued calls count as running calls
+        /// of their connections, so `disconnect(true)` (and the destructor of the `signal`)
+        /// waits for them as well; a target disconnected before its queued call executes
+        /// does not get called anymore. A task disposed by the `executor` without being
+        /// executed (e.g., by destroying an `event_loop`) releases its running call, too.
+        /// Hence, destroying the `signal` on the only thread executing its pending tasks
+        /// blocks forever; a queued connection (`connect(event_loop&, target)`) drops
+        /// its pending calls on disconnecting instead. An exception thrown by a target
+        /// propagates out of the executed task (its running call gets released anyway),
+        /// so the `executor` decides what happens with it; a `thread_pool` catches it.
+        template<typename EXECUTOR, typename... ARGS>
+        inline void post(EXECUTOR& executor, ARGS&&... args) const {
+            typedef std::tuple<typename std::decay<ARGS>::type...> args_tuple;
+            std::shared_ptr<args_tuple> stored; // shared by all queued calls
+
+            read_scope guard(m_threading); // keeps the targets snapshot alive
+
+            auto t = get_targets();
+            if(!t) { return; }
+
+            for(auto g : t->groups) {
+                for(auto& i : *g) {
+                    if(!i.conn.connected()) { continue; }
+                    if(!stored) { stored = std::make_shared<args_tuple>(std::forward<ARGS>(args)...); }
+                    if(!i.conn.enter()) { continue; }
+
+                    // once the call exists it releases the running call itself if it gets
+                    // disposed without being executed, e.g., if `executor.post()` throws
+                    executor.post(make_queued_call<args_tuple>(i.conn, stored));
+                }
+            }
+        }
+
+        /// Fires the signal asynchronously on the default `thread_pool` (see `post()`).
+        /// Other than with `fire()`, an exception thrown by a target does not reach the
+        /// caller: the pool passes it to its exception handler (see
+        /// `thread_pool::set_exception_handler()`) or drops it, and keeps running.
+        template<typename... ARGS>
+        inline void fire_async(ARGS&&... args) const { post(thread_pool::instance(), std::forward<ARGS>(args)...); }
+
+        /// Fires the signal with the targets split into chunks which get processed in
+        /// parallel on the given `executor` (see `post()`) and on the calling thread; returns
+        /// once all targets have been called. Signals with fewer targets than
+        /// `options.serial_threshold` get fired serially. The targets get called in no
+        /// particular order and concurrently, and all of them get passed the same arguments
+        /// (as lvalues). If a target throws, the remaining targets of its chunk get
+        /// skipped and the first exception gets rethrown once all chunks are finished.
+        template<typename EXECUTOR, typename... ARGS>
+        inline void fire_parallel_on(EXECUTOR& executor, parallel_options const& options, ARGS&&... args) const {
+            read_scope guard(m_threading); // keeps the targets snapshot alive for all chunks
+
+            auto t = get_targets();
+            if(!t) { return; }
+
+            if(!use_parallel(t, options)) {
+                dispatch([&](TARGET const& target) { target(args...); });
+                return;
+            }
+
+            auto process = [&](chunk const& c) {
+                for(auto i = c.first; i != c.last; ++i) { i->conn.call([&]() { i->target()(args...); }); }
+            };
+            run_parallel(executor, options, t, process);
+        }
+
+        /// Fires the signal in parallel on the default `thread_pool` (see `fire_parallel_on()`).
+        template<typename... ARGS>
+        inline void fire_parallel(ARGS&&... args) const {
+            fire_parallel_on(thread_pool::instance(), parallel_options(), std::forward<ARGS>(args)...);
+        }
+
+        /// Fires the signal in parallel (see `fire_parallel_on()`) and reduces the return
+        /// values in parallel: each chunk aggregates its return values into its own copy of
+        /// `combiner.neutral()` and these partial results get merged into `combiner` via its
+        /// `merge()` method; returns `combiner.result()`. The merge order is unspecified, so only order
+        /// independent combiners (e.g., `sum`, `min`, `max`, `all_of` or `any_of`) give
+        /// deterministic results.
+        template<typename EXECUTOR, typename COMBINER, typename... ARGS>
+        inline typename std::decay<COMBINER>::type::result_type fire_parallel_collect_on(
+            EXECUTOR& executor, parallel_options const& options, COMBINER&& combiner, ARGS&&... args
+        ) const {
+            typedef typename std::decay<COMBINER>::type combiner_type;
+
+            read_scope guard(m_threading); // keeps the targets snapshot alive for all chunks
+
+            auto t = get_targets();
+            if(!t) { return combiner.result(); }
+
+            if(!use_parallel(t, options)) {
+                dispatch([&](TARGET const& target) { return detail::invoke_proceed(combiner, target(args...)); });
+                return combiner.result();
+            }
+
+            // each chunk starts from a neutral combiner, so the initial state of
+            // `combiner` (e.g., the `init` value of a `sum`) gets counted only once
+            const combiner_type neutral(combiner.neutral());
+            std::mutex merge_mutex;
+            auto process = [&](chunk const& c) {
+                combiner_type partial(neutral);
+                bool proceed = true;
+                for(auto i = c.first; proceed && (i != c.last); ++i) {
+                    i->conn.call([&]() { proceed = detail::invoke_proceed(partial, i->target()(args...)); });
+                }
+
+                std::lock_guard<std::mutex> lock(merge_mutex);
+                combiner.merge(partial);
+            };
+            run_parallel(executor, options, t, process);
+            return combiner.result();
+        }
+
+        /// Fires the signal in parallel on the default `thread_pool` and reduces the return
+        /// values in parallel (see `fire_parallel_collect_on()`).
+        template<typename COMBINER, typename... ARGS>
+        inline typename std::decay<COMBINER>::type::result_type fire_parallel_collect(COMBINER&& combiner, ARGS&&... args) const {
+            return fire_parallel_collect_on(thread_pool::instance(), parallel_options(), std::forward<COMBINER>(combiner), std::forward<ARGS>(args)...);
+        }
+
+        /// Fires the signal and stops as soon as a target reports that it has handled
+        /// the event by returning `true` (the remaining targets do not get called);
+        /// returns whether the event got handled. Requires a `bool` return type of
+        /// the signature.
+        template<typename... ARGS>
+        inline bool fire_until_handled(ARGS&&... args) const {
+            return fire_collect(combiners::any_of(), std::forward<ARGS>(args)...);
+        }
+
 #else // defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
 
         inline void fire_if(bool condition) const {
             if(condition) {
-                if(auto t = get_targets()) {
-                    for(auto& i : *t) {
-                        i.conn.call([&]() { i.target(); });
-                    }
-                }
+                dispatch([&](TARGET const& target) { target(); });
             }
         }
         inline void fire() const {
@@ -174,11 +506,7 @@ namespace signals {
         template<typename ARG1>
         inline void fire_if(bool condition, ARG1&& arg1) const {
             if(condition) {
-                if(auto t = get_targets()) {
-                    for(auto& i : *t) {
-                        i.conn.call([&]() { i.target(std::forward<ARG1>(arg1)); });
-                    }
-                }
+                dispatch([&](TARGET const& target) { target(std::forward<ARG1>(arg1)); });
             }
         }
         template<typename ARG1>
@@ -189,11 +517,7 @@ namespace signals {
         template<typename ARG1, typename ARG2>
         inline void fire_if(bool condition, ARG1&& arg1, ARG2&& arg2) const {
             if(condition) {
-                if(auto t = get_targets()) {
-                    for(auto& i : *t) {
-                        i.conn.call([&]() { i.target(std::forward<ARG1>(arg1), std::forward<ARG2>(arg2)); });
-                    }
-                }
+                dispatch([&](TARGET const& target) { target(std::forward<ARG1>(arg1), std::forward<ARG2>(arg2)); });
             }
         }
         template<typename ARG1, typename ARG2>
@@ -204,11 +528,7 @@ namespace signals {
         template<typename ARG1, typename ARG2, typename ARG3>
         inline void fire_if(bool condition, ARG1&& arg1, ARG2&& arg2, ARG3&& arg3) const {
             if(condition) {
-                if(auto t = get_targets()) {
-                    for(auto& i : *t) {
-                        i.conn.call([&]() { i.target(std::forward<ARG1>(arg1), std::forward<ARG2>(arg2), std::forward<ARG3>(arg3)); });
-                    }
-                }
+                dispatch([&](TARGET const& target) { target(std::forward<ARG1>(arg1), std::forward<ARG2>(arg2), std::forward<ARG3>(arg3)); });
             }
         }
         template<typename ARG1, typename ARG2, typename ARG3>
@@ -219,11 +539,7 @@ namespace signals {
         template<typename ARG1, typename ARG2, typename ARG3, typename ARG4>
         inline void fire_if(bool condition, ARG1&& arg1, ARG2&& arg2, ARG3&& arg3, ARG4&& arg4) const {
             if(condition) {
-                if(auto t = get_targets()) {
-                    for(auto& i : *t) {
-                        i.conn.call([&]() { i.target(std::forward<ARG1>(arg1), std::forward<ARG2>(arg2), std::forward<ARG3>(arg3), std::forward<ARG4>(arg4)); });
-                    }
-                }
+                dispatch([&](TARGET const& target) { target(std::forward<ARG1>(arg1), std::forward<ARG2>(arg2), std::forward<ARG3>(arg3), std::forward<ARG4>(arg4)); });
             }
         }
         template<typename ARG1, typename ARG2, typename ARG3, typename ARG4>
@@ -234,11 +550,7 @@ namespace signals {
         template<typename ARG1, typename ARG2, typename ARG3, typename ARG4, typename ARG5>
         inline void fire_if(bool condition, ARG1&& arg1, ARG2&& arg2, ARG3&& arg3, ARG4&& arg4, ARG5&& arg5) const {
             if(condition) {
-                if(auto t = get_targets()) {
-                    for(auto& i : *t) {
-                        i.conn.call([&]() { i.target(std::forward<ARG1>(arg1), std::forward<ARG2>(arg2), std::forward<ARG3>(arg3), std::forward<ARG4>(arg4), std::forward<ARG5>(arg5)); });
-                    }
-                }
+                dispatch([&](TARGET const& target) { target(std::forward<ARG1>(arg1), std::forward<ARG2>(arg2), std::forward<ARG3>(arg3), std::forward<ARG4>(arg4), std::forward<ARG5>(arg5)); });
             }
         }
         template<typename ARG1, typename ARG2, typename ARG3, typename ARG4, typename ARG5>
@@ -249,19 +561,25 @@ namespace signals {
 #endif // defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
 
     public:
-        inline signal(signal&& o) SIGNALS_CPP_NOEXCEPT {
-            std::lock_guard<std::mutex> lock(o.m_write_targets_mutex);
-            m_targets = std::move(o.m_targets);
+        inline signal(signal&& o) SIGNALS_CPP_NOEXCEPT : m_allocator(o.m_allocator), m_targets(nullptr), m_compaction_requested(false) {
+            std::lock_guard<mutex_type> lock(o.m_write_targets_mutex);
+            m_targets.store(o.m_targets.exchange(nullptr, std::memory_order_acq_rel), std::memory_order_release);
         }
 
         inline signal& operator=(signal&& o) SIGNALS_CPP_NOEXCEPT {
-            // use std::lock(...) in combination with std::defer_lock to acquire two locks
-            // without worrying about potential deadlocks (see: http://en.cppreference.com/w/cpp/thread/lock)
-            std::unique_lock<std::mutex> lock1(m_write_targets_mutex,   std::defer_lock);
-            std::unique_lock<std::mutex> lock2(o.m_write_targets_mutex, std::defer_lock);
-            std::lock(lock1, lock2);
+            targets* old_targets = nullptr;
+
+            {   // use std::lock(...) in combination with std::defer_lock to acquire two locks
+                // without worrying about potential deadlocks (see: http://en.cppreference.com/w/cpp/thread/lock)
+                std::unique_lock<mutex_type> lock1(m_write_targets_mutex,   std::defer_lock);
+                std::unique_lock<mutex_type> lock2(o.m_write_targets_mutex, std::defer_lock);
+                std::lock(lock1, lock2);
 
-            m_targets = std::move(o.m_targets);
+                auto t = o.m_targets.exchange(nullptr, std::memory_order_acq_rel);
+                old_targets = m_targets.exchange(t, std::memory_order_acq_rel);
+            }
+
+            retire_targets(old_targets, true);
             return *this;
         }
 
@@ -270,23 +588,593 @@ namespace signals {
         signal& operator=(signal const& o); // = delete;
 
     private:
-        struct connection_target {
-            inline connection_target(connection c, std::function<SIGNATURE> t) :
-                conn(std::move(c)), target(std::move(t))
+        /// A slot node holds the state of a `connection` and its target callback in
+        /// a single allocation; it gets deleted with the last `connection` handle.
+        struct slot_node;
+        typedef typename detail::rebind_alloc<ALLOCATOR, slot_node>::type node_allocator;
+
+        struct slot_node : connection::data, private node_allocator { // (empty) allocator as base for EBO
+            inline slot_node(TARGET t, node_allocator const& alloc) :
+                connection::data(&destroy_node), node_allocator(alloc), target(std::move(t))
             { }
 
+            inline static slot_node* create(TARGET t, ALLOCATOR const& alloc) {
+                node_allocator a(alloc);
+                detail::allocation_guard<node_allocator> mem(a);
+                ::new(static_cast<void*>(mem.ptr)) slot_node(std::move(t), a);
+                return mem.release();
+            }
+
+            inline node_allocator get_node_allocator() const { return *this; }
+
+            inline static void destroy_node(connection::data* d) {
+                auto n = static_cast<slot_node*>(d);
+                node_allocator a(n->get_node_allocator());
+                n->~slot_node();
+                a.deallocate(n, 1);
+            }
+
+            TARGET target;
+        };
+
+#if defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
+
+        /// Calls a batch target with a batch consisting of a single argument tuple.
+        struct batch_forwarder {
+            template<typename... ARGS>
+            inline void operator()(ARGS&&... args) const {
+                const args_tuple single(std::forward<ARGS>(args)...);
+                (*batch)(batch_span(&single, 1));
+            }
+
+            batch_target const* batch;
+        };
+
+        /// The slot node of a target connected via `connect_batch()`: its `target` calls
+        /// the `batch` target for a single fire, while `fire_batch()` recognizes the node
+        /// by its `destroy` function and passes the whole batch to `batch` directly.
+        struct batch_slot_node : slot_node {
+            typedef typename detail::rebind_alloc<ALLOCATOR, batch_slot_node>::type allocator_type;
+
+            inline batch_slot_node(batch_target b, node_allocator const& alloc) :
+                slot_node(TARGET(batch_forwarder{ &batch }), alloc), batch(std::move(b))
+            {
+                this->connection::data::destroy = &destroy_batch_node;
+            }
+
+            inline static batch_slot_node* create(batch_target b, ALLOCATOR const& alloc) {
+                allocator_type a(alloc);
+                detail::allocation_guard<allocator_type> mem(a);
+                ::new(static_cast<void*>(mem.ptr)) batch_slot_node(std::move(b), node_allocator(alloc));
+                return mem.release();
+            }
+
+            inline static void destroy_batch_node(connection::data* d) {
+                auto n = static_cast<batch_slot_node*>(d);
+                allocator_type a(n->get_node_allocator());
+                n->~batch_slot_node();
+                a.deallocate(n, 1);
+            }
+
+            batch_target batch;
+        };
+
+        /// The slot node of a throttled connection: holds the actual target and the
+        /// `throttle` next to the forwarding `target`, so the connection needs a single
+        /// allocation and the forwarder only a raw pointer.
+        struct throttled_slot_node : slot_node {
+            typedef typename detail::rebind_alloc<ALLOCATOR, throttled_slot_node>::type allocator_type;
+            typedef detail::throttled_slot<TARGET> throttled_slot;
+
+            inline throttled_slot_node(throttle const& limit, TARGET t, node_allocator const& alloc) :
+                slot_node(TARGET(detail::throttled_forwarder<throttled_slot>{ &throttled }), alloc), throttled(limit, std::move(t))
+            {
+                this->connection::data::destroy = &destroy_throttled_node;
+            }
+
+            inline static throttled_slot_node* create(throttle const& limit, TARGET t, ALLOCATOR const& alloc) {
+                allocator_type a(alloc);
+                detail::allocation_guard<allocator_type> mem(a);
+                ::new(static_cast<void*>(mem.ptr)) throttled_slot_node(limit, std::move(t), node_allocator(alloc));
+                return mem.release();
+            }
+
+            inline static void destroy_throttled_node(connection::data* d) {
+                auto n = static_cast<throttled_slot_node*>(d);
+                allocator_type a(n->get_node_allocator());
+                n->~throttled_slot_node();
+                a.deallocate(n, 1);
+            }
+
+            throttled_slot throttled;
+        };
+
+        /// A call of a target queued by `post()`; the running count of its `connection`
+        /// got incremented by `connection::enter()` already and gets decremented exactly
+        /// once: after the call, or on destruction if the executor disposed the task
+        /// without executing it. The call runs at most once, even if the executor copied
+        /// the task. The `connection` handle keeps the slot node alive.
+        template<typename ARGS_TUPLE>
+        struct queued_call {
+            inline queued_call(connection c, std::shared_ptr<ARGS_TUPLE> a) : state(std::make_shared<pending>(std::move(c), std::move(a))) { }
+
+            inline void operator()() const {
+                if(state->started.exchange(true, std::memory_order_acq_rel)) { return; }
+
+                leave_scope scope(state->conn);
+                if(state->conn.connected()) {
+                    detail::apply(static_cast<slot_node const*>(state->conn.get())->target, *state->args);
+                }
+            }
+
+            struct pending {
+                inline pending(connection c, std::shared_ptr<ARGS_TUPLE> a) : conn(std::move(c)), args(std::move(a)), started(false) { }
+                inline ~pending() { if(!started.load(std::memory_order_acquire)) { conn.leave(); } }
+
+                connection                  conn;
+                std::shared_ptr<ARGS_TUPLE> args;
+                std::atomic<bool>           started;
+
+            private:
+                pending(pending const& o); // = delete;
+                pending& operator=(pending const& o); // = delete;
+            };
+
+            struct leave_scope {
+                inline explicit leave_scope(connection const& c) : m_conn(c) { }
+                inline ~leave_scope() { m_conn.leave(); }
+
+            private:
+                connection const& m_conn;
+                leave_scope& operator=(leave_scope const& o); // = delete;
+            };
+
+            std::shared_ptr<pending> state; // shared by all copies of the task
+        };
+
+        /// Creates the `queued_call` for the already entered connection `c`; releases the
+        /// running call if that fails.
+        template<typename ARGS_TUPLE>
+        inline static queued_call<ARGS_TUPLE> make_queued_call(connection const& c, std::shared_ptr<ARGS_TUPLE> const& a) {
+            try {
+                return queued_call<ARGS_TUPLE>(c, a);
+            } catch(...) {
+                c.leave();
+                throw;
+            }
+        }
+
+#endif // defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
+
+        struct connection_target {
+            inline explicit connection_target(slot_node* node) : conn(node) { }
+
+            inline slot_node const& node() const { return *static_cast<slot_node const*>(conn.get()); }
+            inline TARGET const& target() const { return node().target; }
+
             connection conn;
-            std::function<SIGNATURE> target;
         };
 
     private:
-        std::shared_ptr<std::vector<connection_target>> get_targets() const {
-            std::lock_guard<std::mutex> lock(m_write_targets_mutex);
-            return m_targets;
+        /// A group holds all targets connected with the same priority. Its `items` get
+        /// reserved up front and never reallocated after the group has been published,
+        /// so `connect()` can append a target in place while `fire()` calls iterate
+        /// over the first `count` items; only once the capacity is exhausted (or too
+        /// many tombstones accumulated) the group gets replaced by a compacted copy.
+        struct group {
+            typedef std::vector<connection_target, typename detail::rebind_alloc<ALLOCATOR, connection_target>::type> items_vector;
+
+            inline group(int prio, typename items_vector::allocator_type const& alloc) : priority(prio), items(alloc), first(nullptr), count(0) { }
+
+            inline typename items_vector::allocator_type get_allocator() const { return items.get_allocator(); }
+
+            inline void reserve(std::size_t capacity) { items.reserve(capacity); first = items.data(); }
+            inline bool has_room(std::size_t n) const { return (items.capacity() - items.size() >= n); }
+
+            // only for writers; appends the slot nodes of the range of `connection`
+            // objects and publishes all of them at once; `has_room()` needs to be `true`
+            template<typename ITER>
+            inline void append(ITER first_conn, ITER last_conn) {
+                assert(has_room(std::distance(first_conn, last_conn)));
+                for(; first_conn != last_conn; ++first_conn) { items.emplace_back(static_cast<slot_node*>(first_conn->get())); }
+                count.store(items.size(), std::memory_order_release);
+            }
+
+            inline std::size_t size() const { return count.load(std::memory_order_acquire); }
+            inline connection_target const* begin() const { return first; }
+            inline connection_target const* end() const { return (first + size()); }
+
+            const int                 priority;
+            items_vector              items; // modified by the writers only
+            connection_target const*  first; // stable, since `items` never grows beyond its reserved capacity
+            std::atomic<std::size_t>  count; // number of published items
+
+        private:
+            group(group const& o); // = delete;
+            group& operator=(group const& o); // = delete;
+        };
+
+        /// A targets snapshot consists of the groups sorted by descending priority. The
+        /// list of groups itself is immutable; adding or replacing a group publishes a
+        /// new snapshot which shares all other groups with the previous one. So inserting
+        /// a target costs a binary search over the groups plus an (amortized) O(1) append
+        /// to its group, and the snapshot never needs to be re-sorted.
+        struct targets {
+            typedef std::vector<group*, typename detail::rebind_alloc<ALLOCATOR, group*>::type> groups_vector;
+
+            inline explicit targets(typename groups_vector::allocator_type const& alloc) : groups(alloc) { }
+
+            inline typename groups_vector::allocator_type get_allocator() const { return groups.get_allocator(); }
+
+            /// Returns the position of the first group with a priority not higher than `priority`.
+            inline typename groups_vector::const_iterator lower_bound(int priority) const {
+                return std::lower_bound(groups.begin(), groups.end(), priority,
+                    [](group const* g, int p) { return (g->priority > p); }
+                );
+            }
+
+            groups_vector groups;
+
+        private:
+            targets(targets const& o); // = delete;
+            targets& operator=(targets const& o); // = delete;
+        };
+
+        /// Owns a new `group` or `targets` object until it gets published.
+        template<typename T>
+        struct holder {
+            inline explicit holder(T* p) : m_ptr(p) { }
+            inline holder(holder&& o) SIGNALS_CPP_NOEXCEPT : m_ptr(o.release()) { }
+            inline ~holder() { delete_object<T>(m_ptr); }
+
+            inline T* operator->() const { return m_ptr; }
+            inline T* get() const { return m_ptr; }
+            inline T* release() { auto p = m_ptr; m_ptr = nullptr; return p; }
+
+        private:
+            T* m_ptr;
+
+        private:
+            holder(holder const& o); // = delete;
+            holder& operator=(holder const& o); // = delete;
+        };
+
+        inline holder<group> create_group(int priority) const {
+            typename detail::rebind_alloc<ALLOCATOR, group>::type a(m_allocator);
+            detail::allocation_guard<typename detail::rebind_alloc<ALLOCATOR, group>::type> mem(a);
+            ::new(static_cast<void*>(mem.ptr)) group(priority, typename group::items_vector::allocator_type(m_allocator));
+            return holder<group>(mem.release());
+        }
+
+        inline holder<targets> create_targets() const {
+            typename detail::rebind_alloc<ALLOCATOR, targets>::type a(m_allocator);
+            detail::allocation_guard<typename detail::rebind_alloc<ALLOCATOR, targets>::type> mem(a);
+            ::new(static_cast<void*>(mem.ptr)) targets(typename targets::groups_vector::allocator_type(m_allocator));
+            return holder<targets>(mem.release());
+        }
+
+        template<typename T>
+        inline static void delete_object(void* p) {
+            if(auto t = static_cast<T*>(p)) {
+                typename detail::rebind_alloc<ALLOCATOR, T>::type a(t->get_allocator());
+                t->~T();
+                a.deallocate(t, 1);
+            }
+        }
+
+        /// The group `g` gets deleted once no `fire()` call can reference it anymore.
+        inline void retire_group(group* g) const {
+            if(g) { m_threading.retire(g, &delete_object<group>); }
+        }
+
+        /// The snapshot `t` gets deleted once no `fire()` call can reference it anymore;
+        /// its groups only if `with_groups` is set (otherwise they are still shared by
+        /// the snapshot replacing `t`).
+        inline void retire_targets(targets* t, bool with_groups) const {
+            if(t) {
+                if(with_groups) { for(auto g : t->groups) { retire_group(g); } }
+                m_threading.retire(t, &delete_object<targets>);
+            }
+        }
+
+        /// Creates a new group with the given `priority` and room for twice the still
+        /// active targets of `g` (if any) plus `extra` new ones, and copies these active
+        /// targets over; must be called with `m_write_targets_mutex` locked.
+        inline holder<group> rebuild_group(group const* g, int priority, std::size_t extra) const {
+            std::size_t live = 0;
+            if(g) {
+                for(auto& i : *g) { if(i.conn.connected()) { ++live; } }
+            }
+
+            auto new_group = create_group(priority);
+            new_group->reserve(std::max<std::size_t>(4, 2 * (live + extra)));
+            if(g) {
+                for(auto& i : *g) {
+                    if(i.conn.connected()) { new_group->items.push_back(i); }
+                }
+            }
+            new_group->count.store(new_group->items.size(), std::memory_order_relaxed);
+            return new_group;
+        }
+
+        /// Inserts the targets of the range of `connection` objects with the given `priority`.
+        template<typename ITER>
+        inline void insert_targets(ITER first, ITER last, int priority) {
+            const std::size_t n = std::distance(first, last);
+            if(n == 0) { return; }
+
+            targets* old_targets = nullptr;
+            group*   old_group   = nullptr;
+            targets* compacted_targets = nullptr;
+            typename targets::groups_vector compacted_groups(m_allocator);
+
+            {   // lock the mutex for writing
+                std::lock_guard<mutex_type> lock(m_write_targets_mutex);
+
+                // drop the tombstones first if some `fire()` call could not do it
+                if(m_compaction_requested.load(std::memory_order_relaxed)) {
+                    m_compaction_requested.store(false, std::memory_order_relaxed);
+                    compacted_targets = compact_locked(compacted_groups);
+                }
+
+                // only writers modify `m_targets` and they are serialized
+                // by the mutex, so a relaxed load is fine here
+                auto t = m_targets.load(std::memory_order_relaxed);
+
+                // find the group of the given priority via binary search
+                std::size_t pos = 0;
+                group* g = nullptr;
+                if(t) {
+                    auto it = t->lower_bound(priority);
+                    pos = (it - t->groups.begin());
+                    if((it != t->groups.end()) && ((*it)->priority == priority)) { g = *it; }
+                }
+
+                if(g && g->has_room(n)) {
+                    // append in place; running `fire()` calls only see the new
+                    // targets once their slots have been published
+                    g->append(first, last);
+                } else {
+                    // the group is full (or does not exist yet): copy its still active
+                    // targets into a new group with twice the capacity (dropping all
+                    // tombstones), so `connect()` is amortized O(1), and publish a new
+                    // snapshot referencing the new group instead of the old one
+                    auto new_group = rebuild_group(g, priority, n);
+                    new_group->append(first, last);
+
+                    auto new_targets = create_targets();
+                    auto& groups = new_targets->groups;
+                    groups.reserve((t ? t->groups.size() : 0) + 1);
+                    if(t) { groups.assign(t->groups.begin(), t->groups.end()); }
+                    if(g) { groups[pos] = new_group.get(); } else { groups.insert(groups.begin() + pos, new_group.get()); }
+                    new_group.release();
+
+                    // publish the new snapshot; readers pick it up without locking
+                    old_targets = m_targets.exchange(new_targets.release(), std::memory_order_acq_rel);
+                    old_group   = g;
+                }
+            }
+
+            // the old snapshots and groups get deleted once no `fire()` call can reference them anymore
+            retire_compacted(compacted_targets, compacted_groups);
+            retire_group(old_group);
+            retire_targets(old_targets, false);
+        }
+
+        /// A range of targets of a group processed as a unit by `fire_parallel()`.
+        struct chunk {
+            connection_target const* first;
+            connection_target const* last;
+        };
+
+        inline static bool use_parallel(targets const* t, parallel_options const& options) {
+            std::size_t count = 0;
+            for(auto g : t->groups) { count += g->size(); }
+            return ((count >= options.serial_threshold) && (count > options.chunk_size) && (options.max_tasks > 1));
+        }
+
+        /// The state shared by the calling thread and the tasks of a `fire_parallel()`
+        /// call: the chunks get claimed one by one via `next`, so the calling thread
+        /// never waits for a task which has not started yet (e.g., if it is a worker of
+        /// the same pool itself). Tasks starting after all chunks have been claimed
+        /// just drop their reference without touching the (then gone) caller's state.
+        template<typename PROCESS>
+        struct parallel_job {
+            inline parallel_job(PROCESS& p) : process(&p), next(0), remaining(0) { }
+
+            inline void work() {
+                for(;;) {
+                    auto k = next.fetch_add(1, std::memory_order_relaxed);
+                    if(k >= chunks.size()) { return; }
+
+                    try {
+                        (*process)(chunks[k]);
+                    } catch(...) {
+                        std::lock_guard<std::mutex> lock(error_mutex);
+                        if(!error) { error = std::current_exception(); }
+                    }
+
+                    if(remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) { detail::unpark_all(&remaining); }
+                }
+            }
+
+            PROCESS*                 process;
+            std::vector<chunk>       chunks;
+            std::atomic<std::size_t> next;
+            std::atomic<unsigned>    remaining; // number of not yet finished chunks
+            std::mutex               error_mutex;
+            std::exception_ptr       error;
+
+        private:
+            parallel_job(parallel_job const& o); // = delete;
+            parallel_job& operator=(parallel_job const& o); // = delete;
+        };
+
+        template<typename EXECUTOR, typename PROCESS>
+        inline static void run_parallel(EXECUTOR& executor, parallel_options const& options, targets const* t, PROCESS& process) {
+            auto job = std::make_shared<parallel_job<PROCESS>>(process);
+
+            const std::size_t chunk_size = std::max<std::size_t>(1, options.chunk_size);
+            for(auto g : t->groups) {
+                auto first = g->begin(), last = g->end();
+                while(first != last) {
+                    auto n = std::min<std::size_t>(chunk_size, last - first);
+                    chunk c = { first, first + n };
+                    job->chunks.push_back(c);
+                    first += n;
+                }
+            }
+            job->remaining.store(static_cast<unsigned>(job->chunks.size()), std::memory_order_relaxed);
+
+            // the calling thread takes part as well
+            const auto tasks = std::min(job->chunks.size(), options.max_tasks) - 1;
+            for(std::size_t i = 0; i < tasks; ++i) {
+                try {
+                    executor.post([job]() { job->work(); });
+                } catch(...) {
+                    break; // the remaining chunks get processed by the calling thread
+                }
+            }
+            job->work();
+
+            for(;;) {
+                auto r = job->remaining.load(std::memory_order_acquire);
+                if(r == 0) { break; }
+                detail::park(&job->remaining, r);
+            }
+
+            if(job->error) { std::rethrow_exception(job->error); }
+        }
+
+        /// Calls `cb` for the target of each active connection of the current snapshot;
+        /// if `cb` returns `false` the remaining targets are skipped. Disconnected
+        /// targets found on the way are counted; once they make up a quarter of the
+        /// visited ones the snapshot gets compacted (see `try_compact()`), so subsequent
+        /// `fire()` calls do not need to visit these tombstones anymore.
+        template<typename CB>
+        inline void dispatch(CB&& cb) const {
+            dispatch_nodes([&](slot_node const& node) { return detail::invoke_proceed(cb, node.target); });
+        }
+
+        /// Like `dispatch()`, but `cb` gets called with the slot node instead of its target.
+        template<typename CB>
+        inline void dispatch_nodes(CB&& cb) const {
+            read_scope guard(m_threading); // keeps the targets snapshot alive
+
+            auto t = get_targets();
+            if(!t) { return; }
+
+            std::size_t visited = 0, tombstones = 0;
+            bool proceed = true;
+            for(auto g : t->groups) {
+                for(auto& i : *g) {
+                    ++visited;
+                    if(!threading_traits::call(i.conn, [&]() { proceed = detail::invoke_proceed(cb, i.node()); })) { ++tombstones; }
+                    if(!proceed) { break; }
+                }
+                if(!proceed) { break; }
+            }
+
+            if(tombstones && (4 * tombstones >= visited)) { try_compact(); }
+        }
+
+        /// Compacts the current snapshot from within `fire()`. Never blocks: if some
+        /// writer currently holds the mutex (or the compaction fails to allocate), the
+        /// compaction gets requested from the next writer instead, unless a later
+        /// `fire()` call gets to it first.
+        inline void try_compact() const {
+            typename targets::groups_vector old_groups(m_allocator);
+            targets* old_targets = nullptr;
+            bool done = false;
+
+            {
+                std::unique_lock<mutex_type> lock(m_write_targets_mutex, std::try_to_lock);
+                if(lock) {
+                    try {
+                        old_targets = compact_locked(old_groups);
+                        m_compaction_requested.store(false, std::memory_order_relaxed);
+                        done = true;
+                    } catch(...) { }
+                }
+            }
+
+            retire_compacted(old_targets, old_groups);
+            if(done) { return; }
+
+            // checks first, so repeated `fire()` calls do not keep writing to the shared cache line
+            if(!m_compaction_requested.load(std::memory_order_relaxed)) {
+                m_compaction_requested.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        /// Replaces the current snapshot by a copy without the disconnected targets
+        /// (groups without any tombstones get shared); must be called with
+        /// `m_write_targets_mutex` locked. Returns the replaced snapshot and adds the
+        /// replaced groups to `old_groups`; both need to be retired by the caller (see
+        /// `retire_compacted()`) after unlocking the mutex. Leaves the current snapshot
+        /// untouched if an allocation fails.
+        inline targets* compact_locked(typename targets::groups_vector& old_groups) const {
+            auto t = m_targets.load(std::memory_order_relaxed);
+            if(!t) { return nullptr; }
+
+            auto new_targets = create_targets();
+            new_targets->groups.reserve(t->groups.size());
+            old_groups.reserve(old_groups.size() + t->groups.size());
+            auto first_old = old_groups.size();
+            try {
+                for(auto g : t->groups) {
+                    std::size_t live = 0;
+                    for(auto& i : *g) { if(i.conn.connected()) { ++live; } }
+
+                    if(live == g->items.size()) {
+                        new_targets->groups.push_back(g); // nothing to compact
+                    } else {
+                        if(live > 0) {
+                            auto new_group = rebuild_group(g, g->priority, 0);
+                            new_targets->groups.push_back(new_group.get());
+                            new_group.release();
+                        }
+                        old_groups.push_back(g);
+                    }
+                }
+            } catch(...) {
+                // drop the already rebuilt groups and keep the current snapshot
+                for(auto g : new_targets->groups) {
+                    if(std::find(t->groups.begin(), t->groups.end(), g) == t->groups.end()) { delete_object<group>(g); }
+                }
+                old_groups.resize(first_old);
+                throw;
+            }
+
+            if(old_groups.size() == first_old) { return nullptr; } // nothing got compacted
+
+            targets* replacement = (new_targets->groups.empty() ? nullptr : new_targets.release());
+            return m_targets.exchange(replacement, std::memory_order_acq_rel);
+        }
+
+        /// Retires the snapshot and groups replaced by `compact_locked()`; the groups
+        /// may only be retired after they got unlinked.
+        inline void retire_compacted(targets* old_targets, typename targets::groups_vector const& old_groups) const {
+            for(auto g : old_groups) { retire_group(g); }
+            retire_targets(old_targets, false);
+        }
+
+        /// Returns the current snapshot of the targets. This is the hot path of each
+        /// `fire()` call: it neither takes `m_write_targets_mutex` nor touches any
+        /// reference count. The caller needs to hold a `read_scope` for as
+        /// long as it accesses the returned snapshot; replaced snapshots get retired
+        /// by `connect()`, `disconnect_all()` and the compaction (also within `fire()`) and
+        /// deleted only after all readers which could still see them are gone (see
+        /// `detail::threading_traits`).
+        inline targets const* get_targets() const {
+            return m_targets.load(std::memory_order_acquire);
         }
 
-        mutable std::mutex m_write_targets_mutex;
-        std::shared_ptr<std::vector<connection_target>> m_targets;
+        ALLOCATOR m_allocator;
+        threading_traits m_threading; // the snapshot reclamation
+        mutable mutex_type m_write_targets_mutex; // serializes the writers only
+        mutable std::atomic<targets*> m_targets; // replaced by the compaction within `fire()` as well
+        mutable std::atomic<bool> m_compaction_requested; // set by a `fire()` call which could not compact
     };
 
 } // namespace signals
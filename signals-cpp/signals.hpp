@@ -23,7 +23,20 @@
 
 #pragma once
 
+#include "coalescing_signal.hpp"
+#include "combiners.hpp"
 #include "config.hpp"
 #include "connection.hpp"
 #include "connections.hpp"
+#include "delegate.hpp"
+#include "event_loop.hpp"
+#include "inplace_function.hpp"
+#include "pool_allocator.hpp"
+#include "realtime_signal.hpp"
+#include "scoped_connection.hpp"
 #include "signal.hpp"
+#include "span.hpp"
+#include "static_signal.hpp"
+#include "thread_pool.hpp"
+#include "threading.hpp"
+#include "throttle.hpp"
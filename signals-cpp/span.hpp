@@ -0,0 +1,67 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <cstddef>
+
+#include "config.hpp"
+
+namespace signals {
+
+    /// A non-owning view of a contiguous sequence of `T` objects (a minimal stand-in
+    /// for C++20's `std::span`), e.g., the batch of argument tuples passed to
+    /// `signal::fire_batch()`.
+    template<typename T>
+    struct span {
+        typedef T               element_type;
+        typedef T*              iterator;
+        typedef std::size_t     size_type;
+
+        inline span() : m_first(nullptr), m_size(0) { }
+        inline span(T* first, std::size_t size) : m_first(first), m_size(size) { }
+        inline span(T* first, T* last) : m_first(first), m_size(last - first) { }
+
+        /// Views the elements of a contiguous container (e.g., `std::vector` or `std::array`).
+        template<typename CONTAINER>
+        inline span(CONTAINER& c) : m_first(c.data()), m_size(c.size()) { }
+
+        inline T* data() const { return m_first; }
+        inline std::size_t size() const { return m_size; }
+        inline bool empty() const { return (m_size == 0); }
+
+        inline T* begin() const { return m_first; }
+        inline T* end() const { return (m_first + m_size); }
+
+        inline T& operator[](std::size_t i) const { return m_first[i]; }
+
+        /// Returns the view of the `count` elements starting at `offset`.
+        inline span subspan(std::size_t offset, std::size_t count) const { return span(m_first + offset, count); }
+
+    private:
+        T*          m_first;
+        std::size_t m_size;
+    };
+
+} // namespace signals
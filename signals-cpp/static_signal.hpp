@@ -0,0 +1,165 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+#include "config.hpp"
+#include "connection.hpp"
+#include "delegate.hpp"
+
+#if defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
+
+namespace signals {
+
+    /// The `static_signal` class stores up to `N` targets inline within the signal
+    /// object itself: no heap memory gets allocated neither on `connect()` nor on
+    /// `fire()`. Firing the signal is just a walk over an array of targets with a single
+    /// (plain) load of the `connected` flag per target; the calls do not get announced
+    /// as running, so `connection::disconnect(true)` does not wait for them.
+    ///
+    /// The default `TARGET` type is a `delegate` instead of the `std::function` used by
+    /// `signal`, since a `std::function` may allocate heap memory for its callable and
+    /// cannot be `constexpr`-constructed; plain function pointers or an `inplace_function`
+    /// can be used as well. So for switching between `signal` and `static_signal` by
+    /// just changing the type, give both the same `TARGET` explicitly (or connect only
+    /// via `connect<T, &T::method>(obj)`, which works with both defaults).
+    ///
+    /// It shares the `connection` vocabulary with `signal`, but the connection state
+    /// lives within the slots of the `static_signal` as well; hence, the `connection`
+    /// handles must not outlive the `static_signal` (which does not disconnect its
+    /// targets on destruction, so it stays trivially destructible for trivial targets).
+    /// A slot gets reused once it got disconnected and no handle refers to it anymore.
+    ///
+    /// A `static_signal` is not synchronized: either use it from a single thread only,
+    /// or connect all targets before firing it from several threads. If the targets are
+    /// known at compile-time (e.g., plain functions) it can be `constexpr`-constructed:
+    ///
+    ///     constexpr signals::static_signal<void(int), 4, void (*)(int)> sig(&on_value, &log_value);
+    template<typename SIGNATURE, std::size_t N, typename TARGET = delegate<SIGNATURE>>
+    struct static_signal {
+        static_assert(N > 0, "a static_signal needs room for at least one target");
+
+        inline SIGNALS_CPP_CONSTEXPR static_signal() : m_slots(), m_size(0) { }
+
+        /// Connects the given targets up front.
+        template<typename... T>
+        inline SIGNALS_CPP_CONSTEXPR explicit static_signal(TARGET first, T... rest) :
+            m_slots{ { static_cast<TARGET&&>(first) }, { TARGET(rest) }... }, m_size(1 + sizeof...(T))
+        {
+            static_assert(sizeof...(T) < N, "too many targets for this static_signal");
+        }
+
+        /// Connects the `target`; throws `std::length_error` if all `N` slots are in use.
+        inline connection connect(TARGET target) {
+            assert(target);
+            auto s = free_slot();
+            s->target = std::move(target);
+            s->state.store(connection::data::connected_flag, std::memory_order_release);
+            return connection(s);
+        }
+
+        /// Connects to the method `METHOD` of `obj` which is known at compile-time.
+        template<typename OBJ, typename detail::method_pointer<OBJ, SIGNATURE>::type METHOD>
+        inline connection connect(OBJ* obj) {
+            assert(obj);
+            return connect(detail::method_target<TARGET, SIGNATURE, OBJ, typename detail::method_pointer<OBJ, SIGNATURE>::type, METHOD>::make(obj));
+        }
+
+        /// Connects to the const method `METHOD` of `obj` which is known at compile-time.
+        template<typename OBJ, typename detail::method_pointer<OBJ, SIGNATURE>::const_type METHOD>
+        inline connection connect(OBJ const* obj) {
+            assert(obj);
+            return connect(detail::method_target<TARGET, SIGNATURE, OBJ const, typename detail::method_pointer<OBJ, SIGNATURE>::const_type, METHOD>::make(obj));
+        }
+
+        /// Disconnects all connected targets; same signature as `signal::disconnect_all()`.
+        /// Since `fire()` does not announce its calls as running (see above), there is
+        /// nothing to wait for even if `wait_if_running` is set, so this always returns
+        /// a zero duration.
+        inline std::chrono::steady_clock::duration disconnect_all(bool wait_if_running) {
+            (void)wait_if_running;
+            for(std::size_t i = 0, n = used(); i < n; ++i) {
+                m_slots[i].state.fetch_and(~unsigned(connection::data::connected_flag), std::memory_order_acq_rel);
+            }
+            return std::chrono::steady_clock::duration::zero();
+        }
+
+        template<typename... ARGS>
+        inline void fire_if(bool condition, ARGS&&... args) const {
+            if(condition) {
+                for(std::size_t i = 0, n = used(); i < n; ++i) {
+                    auto& s = m_slots[i];
+                    if((s.state.load(std::memory_order_relaxed) & connection::data::connected_flag) && !s.blocked()) { s.target(std::forward<ARGS>(args)...); }
+                }
+            }
+        }
+        template<typename... ARGS>
+        inline void fire(ARGS&&... args) const { fire_if(true, std::forward<ARGS>(args)...); }
+
+        /// Returns the maximum number of targets.
+        inline SIGNALS_CPP_CONSTEXPR std::size_t capacity() const { return N; }
+
+    private:
+        /// A slot holds the connection state (not owned by the `connection` handles)
+        /// and the target.
+        struct slot : connection::data {
+            inline SIGNALS_CPP_CONSTEXPR slot() : connection::data(nullptr, 0), target() { }
+            inline SIGNALS_CPP_CONSTEXPR slot(TARGET t) : connection::data(nullptr), target(static_cast<TARGET&&>(t)) { }
+
+            TARGET target;
+        };
+
+        /// Returns the number of slots used so far; clamped to `N` so that optimizing
+        /// compilers can see that the loops over `m_slots` stay within the array.
+        inline std::size_t used() const { return std::min(m_size, N); }
+
+        /// Returns the first slot which is neither connected nor referenced by any
+        /// `connection` handle anymore.
+        inline slot* free_slot() {
+            for(std::size_t i = 0, n = used(); i < n; ++i) {
+                auto& s = m_slots[i];
+                if(!(s.state.load(std::memory_order_acquire) & connection::data::connected_flag) && (s.refs.load(std::memory_order_acquire) == 0)) { return &s; }
+            }
+            if(m_size == N) { throw std::length_error("static_signal: all slots are in use"); }
+            return &m_slots[m_size++];
+        }
+
+        slot        m_slots[N];
+        std::size_t m_size; // number of slots used so far
+
+    private:
+        static_signal(static_signal const& o); // = delete;
+        static_signal& operator=(static_signal const& o); // = delete;
+    };
+
+} // namespace signals
+
+#endif // defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
@@ -0,0 +1,217 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "config.hpp"
+
+namespace signals {
+
+    /// Controls how `signal::fire_parallel()` splits the targets of a signal.
+    struct parallel_options {
+        inline parallel_options() :
+            chunk_size(256), serial_threshold(1024), max_tasks(std::thread::hardware_concurrency())
+        { }
+
+        std::size_t chunk_size;       // number of targets processed as a single unit of work
+        std::size_t serial_threshold; // below this number of targets the signal gets fired serially
+        std::size_t max_tasks;        // maximum number of threads (incl. the calling one) working on a single fire
+    };
+
+    /// The `thread_pool` class is a small work-stealing executor used by
+    /// `signal::fire_async()`. Each worker thread owns a task queue: tasks posted
+    /// from a worker get pushed to its own queue and are executed LIFO (cache
+    /// friendly for tasks spawning tasks), tasks posted from other threads are
+    /// distributed round-robin. Idle workers steal the oldest tasks from the queues
+    /// of the other workers before going to sleep.
+    ///
+    /// An exception thrown by a task does not leave its worker thread: it gets passed
+    /// to the handler set via `set_exception_handler()`, or dropped if there is none.
+    ///
+    /// Any other executor providing a `post(std::function<void()>)` method can be
+    /// used with `signal::post()` as well.
+    struct thread_pool {
+        typedef std::function<void()> task;
+        typedef std::function<void(std::exception_ptr)> exception_handler;
+
+        inline explicit thread_pool(std::size_t threads = default_thread_count()) :
+            m_pending(0), m_sleeping(0), m_next(0), m_stop(false)
+        {
+            if(threads == 0) { threads = 1; }
+            for(std::size_t i = 0; i < threads; ++i) { m_queues.emplace_back(new worker_queue()); }
+            for(std::size_t i = 0; i < threads; ++i) { m_threads.emplace_back([this, i]() { run_worker(i); }); }
+        }
+
+        /// Executes all still pending tasks and joins the worker threads.
+        inline ~thread_pool() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_cv.notify_all();
+            for(auto&& t : m_threads) { t.join(); }
+        }
+
+        inline std::size_t size() const { return m_threads.size(); }
+
+        /// Queues the task `t` for being executed on one of the worker threads.
+        inline void post(task t) {
+            auto& self = current_worker();
+            auto index = ((self.pool == this) ? self.index : (m_next.fetch_add(1, std::memory_order_relaxed) % m_queues.size()));
+
+            // count the task before it becomes visible, so `m_pending` never drops below zero
+            m_pending.fetch_add(1);
+            {
+                auto& q = *m_queues[index];
+                std::lock_guard<std::mutex> lock(q.mutex);
+                q.tasks.push_back(std::move(t));
+            }
+
+            // pairs with the check of `m_pending` by a worker going to sleep: either
+            // the worker sees the new task or this thread sees the sleeping worker
+            if(m_sleeping.load() > 0) {
+                { std::lock_guard<std::mutex> lock(m_mutex); }
+                m_cv.notify_one();
+            }
+        }
+
+        /// Sets the `handler` getting called on the worker thread with each exception
+        /// thrown by a task; an empty `handler` drops the exceptions (the default).
+        /// The `handler` must not throw itself.
+        inline void set_exception_handler(exception_handler handler) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_handler = std::move(handler);
+        }
+
+        /// The process wide default `thread_pool` with one worker per hardware thread.
+        inline static thread_pool& instance() {
+            static thread_pool pool;
+            return pool;
+        }
+
+        inline static std::size_t default_thread_count() {
+            auto n = std::thread::hardware_concurrency();
+            return ((n > 0) ? n : 2);
+        }
+
+    private:
+        struct worker_queue {
+            std::mutex       mutex;
+            std::deque<task> tasks;
+        };
+
+        struct worker_id {
+            thread_pool const* pool;
+            std::size_t        index;
+        };
+
+        inline static worker_id& current_worker() {
+            static SIGNALS_CPP_THREAD_LOCAL worker_id t_id = { nullptr, 0 };
+            return t_id;
+        }
+
+        /// Takes the newest task of the own queue or steals the oldest one of another queue.
+        inline bool take(std::size_t index, task& t) {
+            {
+                auto& q = *m_queues[index];
+                std::lock_guard<std::mutex> lock(q.mutex);
+                if(!q.tasks.empty()) {
+                    t = std::move(q.tasks.back());
+                    q.tasks.pop_back();
+                    return true;
+                }
+            }
+
+            for(std::size_t i = 1; i < m_queues.size(); ++i) {
+                auto& q = *m_queues[(index + i) % m_queues.size()];
+                std::lock_guard<std::mutex> lock(q.mutex);
+                if(!q.tasks.empty()) {
+                    t = std::move(q.tasks.front());
+                    q.tasks.pop_front();
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        inline void handle_exception(std::exception_ptr error) {
+            exception_handler handler;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                handler = m_handler;
+            }
+            if(handler) { handler(error); }
+        }
+
+        inline void run_worker(std::size_t index) {
+            worker_id id = { this, index };
+            current_worker() = id;
+
+            for(;;) {
+                task t;
+                if(take(index, t)) {
+                    m_pending.fetch_sub(1, std::memory_order_relaxed);
+                    try {
+                        t();
+                    } catch(...) {
+                        handle_exception(std::current_exception());
+                    }
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_sleeping.fetch_add(1);
+                m_cv.wait(lock, [&]() { return ((m_pending.load() > 0) || m_stop); });
+                m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+                if(m_stop && (m_pending.load() == 0)) { return; }
+            }
+        }
+
+        std::vector<std::unique_ptr<worker_queue>> m_queues;
+        std::vector<std::thread>                   m_threads;
+        std::atomic<std::size_t>                   m_pending;  // number of queued tasks
+        std::atomic<std::size_t>                   m_sleeping; // number of workers waiting on `m_cv`
+        std::atomic<std::size_t>                   m_next;     // round-robin index for external posts
+        std::mutex                                 m_mutex;
+        std::condition_variable                    m_cv;
+        bool                                       m_stop;     // guarded by `m_mutex`
+        exception_handler                          m_handler;  // guarded by `m_mutex`
+
+    private:
+        thread_pool(thread_pool const& o); // = delete;
+        thread_pool& operator=(thread_pool const& o); // = delete;
+    };
+
+} // namespace signals
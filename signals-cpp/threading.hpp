@@ -0,0 +1,167 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "config.hpp"
+#include "connection.hpp"
+#include "detail/epoch.hpp"
+
+namespace signals {
+
+    /// A mutex which does nothing; used by signals which are only ever accessed by
+    /// a single thread.
+    struct null_mutex {
+        inline void lock() { }
+        inline bool try_lock() { return true; }
+        inline void unlock() { }
+    };
+
+    /// A test-and-test-and-set spinlock which yields the thread after spinning for
+    /// a while; suited for the short critical sections of the signal writers.
+    struct spin_mutex {
+        inline spin_mutex() : m_locked(false) { }
+
+        inline void lock() {
+            for(unsigned spins = 0; !try_lock(); ++spins) {
+                while(m_locked.load(std::memory_order_relaxed)) {
+                    if(++spins >= 64) { std::this_thread::yield(); }
+                }
+            }
+        }
+        inline bool try_lock() { return !m_locked.exchange(true, std::memory_order_acquire); }
+        inline void unlock() { m_locked.store(false, std::memory_order_release); }
+
+    private:
+        std::atomic<bool> m_locked;
+
+    private:
+        spin_mutex(spin_mutex const& o); // = delete;
+        spin_mutex& operator=(spin_mutex const& o); // = delete;
+    };
+
+    /// The threading policies of a `signal`: they select the mutex serializing the
+    /// writers (`connect()`, `disconnect_all()`, ...) and whether `fire()` has to be
+    /// safe against concurrent writers and `disconnect()` calls from other threads.
+    namespace threading {
+
+        /// The default: `fire()` is lock-free and the writers are serialized by a `std::mutex`.
+        struct mutex {
+            typedef std::mutex mutex_type;
+            enum { concurrent = true };
+        };
+
+        /// Like `mutex`, but the writers are serialized by a `spin_mutex`.
+        struct spinlock {
+            typedef spin_mutex mutex_type;
+            enum { concurrent = true };
+        };
+
+        /// For signals which are only ever accessed by a single thread (including the
+        /// `disconnect()` calls of their connections): no locks, and `fire()` just walks
+        /// the targets without any atomic read-modify-write operations and without
+        /// entering an epoch.
+        struct single_threaded {
+            typedef null_mutex mutex_type;
+            enum { concurrent = false };
+        };
+
+    } // namespace threading
+
+    namespace detail {
+
+        /// The parts of the `fire()` path and of the snapshot reclamation depending on
+        /// whether the signal is accessed concurrently or not.
+        template<bool CONCURRENT>
+        struct threading_traits;
+
+        /// Concurrent readers are protected by the global `epoch_domain`.
+        template<>
+        struct threading_traits<true> {
+            struct read_scope {
+                inline explicit read_scope(threading_traits const&) { }
+
+                epoch_guard guard;
+            };
+
+            inline void retire(void* p, void (*deleter)(void* p)) const { epoch_domain::instance().retire(p, deleter); }
+
+            template<typename CB>
+            inline static bool call(connection const& conn, CB&& cb) { return conn.call(std::forward<CB>(cb)); }
+        };
+
+        /// A single thread only needs to defer the deletion of snapshots replaced while
+        /// it is firing the signal (e.g., by a target connecting another one) until the
+        /// outermost `fire()` returns.
+        template<>
+        struct threading_traits<false> {
+            inline threading_traits() : m_depth(0) { }
+            inline ~threading_traits() { reclaim(); }
+
+            struct read_scope {
+                inline explicit read_scope(threading_traits const& t) : m_traits(t) { ++m_traits.m_depth; }
+                inline ~read_scope() { if(--m_traits.m_depth == 0) { m_traits.reclaim(); } }
+
+            private:
+                threading_traits const& m_traits;
+
+            private:
+                read_scope(read_scope const& o); // = delete;
+                read_scope& operator=(read_scope const& o); // = delete;
+            };
+
+            inline void retire(void* p, void (*deleter)(void* p)) const {
+                if(m_depth == 0) { deleter(p); return; }
+                m_retired.push_back(std::make_pair(p, deleter));
+            }
+
+            template<typename CB>
+            inline static bool call(connection const& conn, CB&& cb) { return conn.call_unsynchronized(std::forward<CB>(cb)); }
+
+        private:
+            inline void reclaim() const {
+                while(!m_retired.empty()) {
+                    auto r = m_retired.back();
+                    m_retired.pop_back();
+                    r.second(r.first);
+                }
+            }
+
+            mutable unsigned                                        m_depth; // nesting of the active `fire()` calls
+            mutable std::vector<std::pair<void*, void (*)(void*)>>  m_retired;
+
+        private:
+            threading_traits(threading_traits const& o); // = delete;
+            threading_traits& operator=(threading_traits const& o); // = delete;
+        };
+
+    } // namespace detail
+
+} // namespace signals
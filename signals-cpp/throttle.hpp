@@ -0,0 +1,143 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "config.hpp"
+
+namespace signals {
+
+    /// A `throttle` limits the rate of calls of the targets connected with it (see
+    /// `signal::connect(throttle, target)`) to at most `max_calls` within any time
+    /// window of length `interval`; calls exceeding that rate get dropped and counted.
+    /// The delivered calls are spaced at least `interval / max_calls` apart, so there
+    /// are no bursts. It implements the generic cell rate algorithm without a burst
+    /// tolerance: the only state checked on the fire path is a single atomic timestamp
+    /// (the earliest time of the next call), which gets compared against the current
+    /// time; only a call which gets delivered updates it.
+    ///
+    /// Copies of a `throttle` share the same rate budget and counters, so keep a copy
+    /// of it in order to inspect the counters.
+    struct throttle {
+        typedef std::chrono::steady_clock clock_type;
+
+        inline throttle(std::uint64_t max_calls, clock_type::duration interval) :
+            m_state(std::make_shared<state>(max_calls, interval))
+        { }
+
+        /// Returns `true` if a call is allowed at time `now` (and accounts for it),
+        /// `false` if it has to be suppressed.
+        inline bool try_acquire(clock_type::time_point now = clock_type::now()) const { return m_state->try_acquire(now); }
+
+        /// Number of calls which got delivered so far.
+        inline std::uint64_t delivered() const { return m_state->delivered.load(std::memory_order_relaxed); }
+
+        /// Number of calls which got suppressed so far.
+        inline std::uint64_t suppressed() const { return m_state->suppressed.load(std::memory_order_relaxed); }
+
+        /// Resets both counters (but not the rate budget).
+        inline void reset_counters() const {
+            m_state->delivered.store(0, std::memory_order_relaxed);
+            m_state->suppressed.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        struct state {
+            inline state(std::uint64_t max_calls, clock_type::duration interval) :
+                emission(emission_interval(max_calls, interval)), tat(0), delivered(0), suppressed(0)
+            {
+                assert(max_calls > 0);
+                assert(interval.count() > 0);
+            }
+
+            /// Rounds up, so that `max_calls` calls never fit into less than `interval`.
+            inline static std::int64_t emission_interval(std::uint64_t max_calls, clock_type::duration interval) {
+                const std::int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count();
+                const std::int64_t n  = std::int64_t(std::max<std::uint64_t>(1, max_calls));
+                return std::max<std::int64_t>(1, (ns + n - 1) / n);
+            }
+
+            inline bool try_acquire(clock_type::time_point now) {
+                const std::int64_t t = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+                auto current = tat.load(std::memory_order_relaxed);
+                for(;;) {
+                    if(t < current) { // too early for the next call
+                        suppressed.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    }
+                    if(tat.compare_exchange_weak(current, t + emission, std::memory_order_relaxed)) {
+                        delivered.fetch_add(1, std::memory_order_relaxed);
+                        return true;
+                    }
+                }
+            }
+
+            const std::int64_t          emission;  // minimum ns between two delivered calls
+            std::atomic<std::int64_t>   tat;       // earliest time of the next call in ns
+            std::atomic<std::uint64_t>  delivered;
+            std::atomic<std::uint64_t>  suppressed;
+        };
+
+        std::shared_ptr<state> m_state;
+    };
+
+#if defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
+
+    namespace detail {
+
+        /// The target of a throttled connection together with its `throttle`.
+        template<typename TARGET>
+        struct throttled_slot {
+            inline throttled_slot(throttle const& l, TARGET t) : limit(l), target(std::move(t)) { }
+
+            throttle    limit;
+            TARGET      target;
+        };
+
+        /// The callable stored in the signal for a throttled connection: a single raw
+        /// pointer to the `throttled_slot`, which lives in the same slot node (so it fits
+        /// into small inline targets as well and copying it touches no reference count).
+        template<typename THROTTLED_SLOT>
+        struct throttled_forwarder {
+            template<typename... ARGS>
+            inline void operator()(ARGS&&... args) const {
+                if(slot->limit.try_acquire()) { slot->target(std::forward<ARGS>(args)...); }
+            }
+
+            THROTTLED_SLOT* slot;
+        };
+
+    } // namespace detail
+
+#endif // defined(SIGNALS_CPP_HAVE_VARIADIC_TEMPLATES)
+
+} // namespace signals
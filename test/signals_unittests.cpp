@@ -301,3 +301,1756 @@ CUTE_TEST(
 
     ticker.reached_tick(11);
 }
+
+CUTE_TEST(
+    "test to fire a signal from several threads while other threads connect and disconnect targets",
+    "[signals],[signals_12],[multi-threaded]"
+) {
+    signals::signal<void(int v)> sig;
+    std::atomic<int> sum(0);
+    std::atomic<bool> done(false);
+
+    auto keep = sig.connect([&](int v) { sum += v; });
+
+    std::vector<cute::thread> firing;
+    for(int i = 0; i < 4; ++i) {
+        firing.emplace_back([&]() {
+            do { sig.fire(1); } while(!done);
+        });
+    }
+
+    for(int i = 0; i < 1000; ++i) {
+        auto conn = sig.connect([&](int v) { sum += v; });
+        conn.disconnect(i % 2 == 0);
+    }
+
+    done = true;
+    for(auto&& t : firing) { t.join(); }
+
+    CUTE_ASSERT(keep.connected());
+    CUTE_ASSERT(sum > 0);
+}
+
+CUTE_TEST(
+    "test that disconnect(true) waits for all running calls and that no call starts afterwards",
+    "[signals],[signals_13],[multi-threaded]"
+) {
+    signals::signal<void()> sig;
+    std::atomic<bool> done(false);
+
+    std::vector<cute::thread> firing;
+    for(int i = 0; i < 4; ++i) {
+        firing.emplace_back([&]() {
+            do { sig.fire(); } while(!done);
+        });
+    }
+
+    for(int i = 0; i < 200; ++i) {
+        std::atomic<int> calls(0);
+        std::atomic<int> inside(0);
+        std::atomic<bool> started(false);
+
+        auto conn = sig.connect([&]() {
+            ++inside;
+            ++calls;
+            started = true;
+            --inside;
+        });
+        while(!started && (i % 4 == 0)) { std::this_thread::yield(); } // sometimes wait for a running call
+
+        CUTE_ASSERT(conn.disconnect(true));
+        CUTE_ASSERT(inside == 0);
+
+        const int calls_after_disconnect = calls;
+        sig.fire();
+        CUTE_ASSERT(calls == calls_after_disconnect);
+    }
+
+    done = true;
+    for(auto&& t : firing) { t.join(); }
+}
+
+CUTE_TEST(
+    "test that several threads can wait in disconnect(true) for the same slow call",
+    "[signals],[signals_14],[multi-threaded]"
+) {
+    signals::signal<void()> sig;
+    std::atomic<bool> entered(false), finished(false);
+
+    auto conn = sig.connect([&]() {
+        entered = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        finished = true;
+    });
+
+    auto firing = cute::thread([&]() { sig.fire(); });
+    while(!entered) { std::this_thread::yield(); }
+
+    std::vector<cute::thread> waiting;
+    for(int i = 0; i < 3; ++i) {
+        waiting.emplace_back([&]() {
+            conn.disconnect(true);
+            CUTE_ASSERT(finished);
+        });
+    }
+
+    conn.disconnect(true);
+    CUTE_ASSERT(finished);
+    for(auto&& t : waiting) { t.join(); }
+    firing.join();
+}
+
+CUTE_TEST(
+    "test a signal storing its targets in an inplace_function",
+    "[signals],[signals_15],[inplace_function],[single-threaded]"
+) {
+    typedef signals::inplace_function<void(int v), 64> target;
+    signals::signal<void(int v), target> sig;
+
+    double a = 1, b = 2, c = 3; // bigger than the small buffer of most std::function implementations
+    int value1 = 0, value2 = 0;
+    sig.connect([a, b, c, &value1](int v) { value1 = v + int(a + b + c); });
+    auto conn = sig.connect([&](int v) { value2 = v; });
+
+    sig.fire(42);
+    CUTE_ASSERT(value1 == 48);
+    CUTE_ASSERT(value2 == 42);
+
+    conn.disconnect();
+    sig.fire(21);
+    CUTE_ASSERT(value1 == 27);
+    CUTE_ASSERT(value2 == 42);
+}
+
+CUTE_TEST(
+    "test copying, moving, and destroying an inplace_function",
+    "[signals],[inplace_function],[single-threaded]"
+) {
+    typedef signals::inplace_function<int(int v), 32> func;
+
+    auto counter = std::make_shared<int>(0);
+
+    func f1 = [counter](int v) { return (*counter += v); };
+    CUTE_ASSERT(static_cast<bool>(f1));
+    CUTE_ASSERT(counter.use_count() == 2);
+
+    func f2 = f1;
+    CUTE_ASSERT(counter.use_count() == 3);
+    CUTE_ASSERT(f2(2) == 2);
+
+    func f3 = std::move(f1);
+    CUTE_ASSERT(!f1);
+    CUTE_ASSERT(counter.use_count() == 3);
+    CUTE_ASSERT(f3(3) == 5);
+
+    f2 = nullptr;
+    CUTE_ASSERT(!f2);
+    CUTE_ASSERT(counter.use_count() == 2);
+
+    func f4 = static_cast<int(*)(int)>(nullptr);
+    CUTE_ASSERT(!f4);
+
+    f3 = func();
+    CUTE_ASSERT(counter.use_count() == 1);
+}
+
+CUTE_TEST(
+    "test to connect to a method known at compile-time",
+    "[signals],[signals_16],[delegate],[single-threaded]"
+) {
+    struct Test {
+        Test() : v(0), calls(0) { }
+
+        void onIntValue(int v_) { v = v_; }
+        void onStringValue(std::string const& s) const { calls += int(s.size()); }
+
+        int v;
+        mutable int calls;
+    };
+
+    Test t;
+
+    signals::signal<void(int)> sigInt;
+    sigInt.connect<Test, &Test::onIntValue>(&t);
+    sigInt.fire(42);
+    CUTE_ASSERT(t.v == 42);
+
+    signals::signal<void(std::string const&)> sigString;
+    auto conn = sigString.connect<Test, &Test::onStringValue>(static_cast<Test const*>(&t));
+    sigString.fire("abc");
+    CUTE_ASSERT(t.calls == 3);
+
+    conn.disconnect();
+    sigString.fire("abc");
+    CUTE_ASSERT(t.calls == 3);
+
+    // a signal storing its targets as plain delegates
+    signals::signal<void(int), signals::delegate<void(int)>> sigDelegate;
+    sigDelegate.connect<Test, &Test::onIntValue>(&t);
+    sigDelegate.fire(84);
+    CUTE_ASSERT(t.v == 84);
+}
+
+namespace {
+    int g_free_function_value = 0;
+    void free_function(int v) { g_free_function_value = v; }
+}
+
+CUTE_TEST(
+    "test calling and comparing delegates",
+    "[signals],[delegate],[single-threaded]"
+) {
+    struct Test {
+        Test() : v(0) { }
+        void onIntValue(int v_) { v = v_; }
+        int v;
+    };
+
+    Test t1, t2;
+    typedef signals::delegate<void(int)> delegate;
+
+    auto d1 = delegate::bind<Test, &Test::onIntValue>(&t1);
+    auto d2 = delegate::bind<Test, &Test::onIntValue>(&t2);
+    auto d3 = delegate::bind<&free_function>();
+    auto d4 = delegate::bind<Test, &Test::onIntValue>(&t1);
+
+    CUTE_ASSERT(!delegate());
+    CUTE_ASSERT(static_cast<bool>(d1));
+    CUTE_ASSERT((d1 == d4));
+    CUTE_ASSERT((d1 != d2));
+
+    d1(1); d2(2); d3(3);
+    CUTE_ASSERT(t1.v == 1);
+    CUTE_ASSERT(t2.v == 2);
+    CUTE_ASSERT(g_free_function_value == 3);
+}
+
+CUTE_TEST(
+    "test that a connection handle can outlive its signal and releases the target with the last reference",
+    "[signals],[signals_17],[single-threaded]"
+) {
+    auto payload = std::make_shared<int>(42);
+    signals::connection conn;
+
+    {
+        signals::signal<void()> sig;
+        conn = sig.connect([payload]() { });
+        CUTE_ASSERT(conn.connected());
+        CUTE_ASSERT(payload.use_count() == 2);
+    }
+
+    CUTE_ASSERT(!conn.connected());
+    CUTE_ASSERT(!conn.disconnect());
+    CUTE_ASSERT(payload.use_count() == 2); // the target is owned by the slot node which is still referenced by `conn`
+
+    conn = signals::connection();
+    CUTE_ASSERT(payload.use_count() == 1);
+}
+
+CUTE_TEST(
+    "test a signal allocating its internal memory from the pool_allocator",
+    "[signals],[signals_18],[pool_allocator],[multi-threaded]"
+) {
+    typedef signals::signal<void(int v), signals::inplace_function<void(int v), 32>, signals::pool_allocator<void>> pool_signal;
+
+    pool_signal sig;
+    std::atomic<int> sum(0);
+
+    std::vector<cute::thread> threads;
+    for(int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            std::vector<signals::connection> conns;
+            for(int i = 0; i < 500; ++i) {
+                conns.push_back(sig.connect([&](int v) { sum += v; }));
+                if(i % 3 == 0) { conns[i / 2].disconnect(); }
+                sig.fire(1);
+            }
+            for(auto&& c : conns) { c.disconnect(); }
+        });
+    }
+    for(auto&& t : threads) { t.join(); }
+
+    CUTE_ASSERT(sum > 0);
+
+    int value = 0;
+    auto conn = sig.connect([&](int v) { value = v; });
+    sig.fire(42);
+    CUTE_ASSERT(value == 42);
+    CUTE_ASSERT(conn.disconnect());
+}
+
+CUTE_TEST(
+    "test allocating and deallocating memory blocks of all sizes via the pool_allocator",
+    "[signals],[pool_allocator],[single-threaded]"
+) {
+    signals::pool_allocator<char> alloc;
+
+    std::vector<std::pair<char*, std::size_t>> blocks;
+    for(std::size_t size = 1; size <= 300; ++size) {
+        auto p = alloc.allocate(size);
+        std::fill(p, p + size, char(size));
+        blocks.emplace_back(p, size);
+    }
+
+    for(auto&& b : blocks) {
+        CUTE_ASSERT(std::count(b.first, b.first + b.second, char(b.second)) == std::ptrdiff_t(b.second));
+        alloc.deallocate(b.first, b.second);
+    }
+
+    signals::pool_allocator<int> other(alloc);
+    CUTE_ASSERT((alloc == other));
+}
+
+CUTE_TEST(
+    "test connecting many slots and compacting the disconnected ones",
+    "[signals],[signals_19],[single-threaded]"
+) {
+    signals::signal<void(int& counter)> sig;
+
+    std::vector<signals::connection> conns;
+    for(int i = 0; i < 10000; ++i) { conns.push_back(sig.connect([](int& counter) { ++counter; })); }
+
+    int counter = 0;
+    sig.fire(counter);
+    CUTE_ASSERT(counter == 10000);
+    CUTE_ASSERT(sig.slot_count() == 10000);
+
+    // a few tombstones get skipped, but do not trigger a compaction yet
+    for(int i = 0; i < 10; ++i) { conns[10 * i + 1].disconnect(); }
+    counter = 0;
+    sig.fire(counter);
+    CUTE_ASSERT(counter == 9990);
+    CUTE_ASSERT(sig.slot_count() == 10000);
+
+    // disconnect 9 out of 10 slots; the first `fire()` compacts the tombstones away
+    for(int i = 0; i < 10000; ++i) { if(i % 10) { conns[i].disconnect(); } }
+    CUTE_ASSERT(sig.slot_count() == 10000);
+    for(int round = 0; round < 3; ++round) {
+        counter = 0;
+        sig.fire(counter);
+        CUTE_ASSERT(counter == 1000);
+        CUTE_ASSERT(sig.slot_count() == 1000);
+    }
+
+    // `compact()` drops the tombstones right away
+    for(int i = 0; i < 10; ++i) { conns[10 * i].disconnect(); }
+    CUTE_ASSERT(sig.slot_count() == 1000);
+    sig.compact();
+    CUTE_ASSERT(sig.slot_count() == 990);
+
+    // slots connected during a `fire()` get called starting with the next `fire()`
+    signals::connections nested;
+    auto conn = sig.connect([&](int&) { nested.add(sig.connect([](int& counter) { counter += 100; })); });
+    counter = 0;
+    sig.fire(counter);
+    CUTE_ASSERT(counter == 990);
+    conn.disconnect();
+    counter = 0;
+    sig.fire(counter);
+    CUTE_ASSERT(counter == 1090);
+
+    for(auto&& c : conns) { c.disconnect(); }
+    nested.disconnect_all();
+    counter = 0;
+    sig.fire(counter);
+    CUTE_ASSERT(counter == 0);
+
+    // the signal is usable again after all slots got compacted away
+    CUTE_ASSERT(sig.slot_count() == 0);
+    auto last = sig.connect([](int& counter) { counter += 7; });
+    sig.fire(counter);
+    CUTE_ASSERT(counter == 7);
+    CUTE_ASSERT(last.disconnect());
+}
+
+CUTE_TEST(
+    "test connecting a range of targets at once",
+    "[signals],[signals_20],[single-threaded]"
+) {
+    signals::signal<void(int& counter)> sig;
+    auto first = sig.connect([](int& counter) { counter += 1000; });
+
+    std::vector<std::function<void(int& counter)>> targets;
+    for(int i = 0; i < 100; ++i) { targets.push_back([i](int& counter) { counter += i; }); }
+
+    auto conns = sig.connect_all(targets);
+    CUTE_ASSERT(conns.size() == 100);
+
+    int counter = 0;
+    sig.fire(counter);
+    CUTE_ASSERT(counter == 1000 + 4950);
+
+    CUTE_ASSERT(conns[10].disconnect());
+    counter = 0;
+    sig.fire(counter);
+    CUTE_ASSERT(counter == 1000 + 4940);
+
+    {
+        signals::connections tracked;
+        auto more = tracked.connect_many(sig, targets.begin(), targets.begin() + 3);
+        CUTE_ASSERT(more.size() == 3);
+        CUTE_ASSERT(sig.connect_all(std::vector<std::function<void(int& counter)>>()).empty());
+
+        counter = 0;
+        sig.fire(counter);
+        CUTE_ASSERT(counter == 1000 + 4940 + 3);
+    }
+
+    for(auto&& c : conns) { c.disconnect(); }
+    conns = sig.connect_all({ [](int& counter) { counter += 1; }, [](int& counter) { counter += 2; } });
+    counter = 0;
+    sig.fire(counter);
+    CUTE_ASSERT(counter == 1000 + 3);
+
+    CUTE_ASSERT(first.disconnect());
+}
+
+CUTE_TEST(
+    "test that disconnect_all(true) waits for all running calls at once and reports the time spent waiting",
+    "[signals],[signals_21],[multi-threaded]"
+) {
+    std::vector<signals::signal<void()>> sigs(8);
+    std::atomic<int> entered(0);
+    std::atomic<int> running(0);
+
+    signals::connections conns;
+    for(auto&& sig : sigs) {
+        conns.connect(sig, [&]() {
+            ++running;
+            ++entered;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            --running;
+        });
+    }
+
+    std::vector<cute::thread> firing;
+    for(int i = 0; i < 4; ++i) { firing.emplace_back([&sigs, i]() { sigs[2 * i].fire(); }); }
+    while(entered < 4) { std::this_thread::yield(); }
+
+    auto waited = conns.disconnect_all(true);
+    CUTE_ASSERT(running == 0);
+    CUTE_ASSERT((waited > std::chrono::steady_clock::duration::zero()));
+    for(auto&& t : firing) { t.join(); }
+
+    // nothing to wait for
+    CUTE_ASSERT((conns.disconnect_all(true) == std::chrono::steady_clock::duration::zero()));
+
+    // the same for all targets of a single signal
+    signals::signal<void()> sig;
+    entered = 0;
+    for(int i = 0; i < 4; ++i) {
+        sig.connect([&]() {
+            ++running;
+            ++entered;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            --running;
+        });
+    }
+
+    cute::thread fire_thread([&]() { sig.fire(); });
+    while(entered < 1) { std::this_thread::yield(); }
+
+    waited = sig.disconnect_all(true);
+    CUTE_ASSERT(running == 0);
+    CUTE_ASSERT(entered == 1); // all other targets got disconnected before they were called
+    CUTE_ASSERT((waited > std::chrono::steady_clock::duration::zero()));
+    fire_thread.join();
+}
+
+CUTE_TEST(
+    "test collecting the return values of the targets via combiners",
+    "[signals],[signals_22],[combiners],[single-threaded]"
+) {
+    signals::signal<int(int v)> sig;
+
+    CUTE_ASSERT(sig.fire_collect(signals::combiners::sum<int>(), 1) == 0);
+    signals::combiners::last<int> none;
+    sig.fire_collect(none, 1);
+    CUTE_ASSERT(none.empty());
+
+    signals::connections conns;
+    conns.connect(sig, [](int v) { return v; });
+    conns.connect(sig, [](int v) { return 3 * v; });
+    auto conn = sig.connect([](int v) { return -v; });
+
+    CUTE_ASSERT(sig.fire_collect(signals::combiners::last<int>(), 2) == -2);
+    CUTE_ASSERT(sig.fire_collect(signals::combiners::sum<int>(), 2) == 6);
+    CUTE_ASSERT(sig.fire_collect(signals::combiners::sum<int>(100), 2) == 106);
+    CUTE_ASSERT(sig.fire_collect(signals::combiners::min<int>(), 2) == -2);
+    CUTE_ASSERT(sig.fire_collect(signals::combiners::max<int>(), 2) == 6);
+
+    signals::combiners::max<int> max;
+    CUTE_ASSERT(sig.fire_collect(max, 5) == 15);
+    CUTE_ASSERT(!max.empty());
+
+    auto product = sig.fire_collect(signals::combiners::make_fold(1LL, [](long long acc, int v) { return acc * v; }), 2);
+    CUTE_ASSERT(product == -24);
+
+    conn.disconnect();
+    CUTE_ASSERT(sig.fire_collect(signals::combiners::sum<int>(), 2) == 8);
+
+    signals::signal<bool(int v)> validate;
+    CUTE_ASSERT(validate.fire_collect(signals::combiners::all_of(), 1));
+    CUTE_ASSERT(!validate.fire_collect(signals::combiners::any_of(), 1));
+    conns.connect(validate, [](int v) { return (v > 0); });
+    conns.connect(validate, [](int v) { return (v < 10); });
+    CUTE_ASSERT(validate.fire_collect(signals::combiners::all_of(), 5));
+    CUTE_ASSERT(!validate.fire_collect(signals::combiners::all_of(), 20));
+    CUTE_ASSERT(validate.fire_collect(signals::combiners::any_of(), 20));
+
+    signals::signal<const char*(int v)> lookup;
+    conns.connect(lookup, [](int)   -> const char* { return nullptr; });
+    conns.connect(lookup, [](int v) -> const char* { return ((v == 1) ? "one" : nullptr); });
+    conns.connect(lookup, [](int)   -> const char* { return "other"; });
+    CUTE_ASSERT(std::string(lookup.fire_collect(signals::combiners::first_non_empty<const char*>(), 1)) == "one");
+    CUTE_ASSERT(std::string(lookup.fire_collect(signals::combiners::first_non_empty<const char*>(), 2)) == "other");
+}
+
+CUTE_TEST(
+    "test stopping the dispatch once a target has handled the event",
+    "[signals],[signals_23],[combiners],[single-threaded]"
+) {
+    signals::signal<bool(int key)> on_key;
+    CUTE_ASSERT(!on_key.fire_until_handled(1));
+
+    std::vector<int> visited;
+    signals::connections conns;
+    conns.connect(on_key, [&](int key) { visited.push_back(1); return (key == 1); });
+    conns.connect(on_key, [&](int key) { visited.push_back(2); return (key <= 2); });
+    conns.connect(on_key, [&](int)     { visited.push_back(3); return true; });
+
+    CUTE_ASSERT(on_key.fire_until_handled(1));
+    CUTE_ASSERT((visited == std::vector<int>{ 1 }));
+
+    visited.clear();
+    CUTE_ASSERT(on_key.fire_until_handled(2));
+    CUTE_ASSERT((visited == std::vector<int>{ 1, 2 }));
+
+    visited.clear();
+    CUTE_ASSERT(on_key.fire_until_handled(5));
+    CUTE_ASSERT((visited == std::vector<int>{ 1, 2, 3 }));
+
+    // `all_of` stops at the first target returning `false`
+    visited.clear();
+    CUTE_ASSERT(!on_key.fire_collect(signals::combiners::all_of(), 2));
+    CUTE_ASSERT((visited == std::vector<int>{ 1 }));
+
+    // a plain `fire()` still calls all targets
+    visited.clear();
+    on_key.fire(1);
+    CUTE_ASSERT((visited == std::vector<int>{ 1, 2, 3 }));
+
+    // a custom combiner can stop the dispatch by returning `false`
+    struct first_two {
+        typedef int result_type;
+        first_two() : count(0) { }
+        bool operator()(bool) { return (++count < 2); }
+        int result() const { return count; }
+        int count;
+    };
+    visited.clear();
+    CUTE_ASSERT(on_key.fire_collect(first_two(), 7) == 2);
+    CUTE_ASSERT((visited == std::vector<int>{ 1, 2 }));
+}
+
+CUTE_TEST(
+    "test calling the targets in the order of their priorities",
+    "[signals],[signals_24],[single-threaded]"
+) {
+    signals::signal<void(std::vector<int>& order)> sig;
+    signals::connections conns;
+
+    auto logging = conns.connect(sig, -10, [](std::vector<int>& order) { order.push_back(-10); });
+    conns.connect(sig, [](std::vector<int>& order) { order.push_back(0); });
+    conns.connect(sig, 100, [](std::vector<int>& order) { order.push_back(100); });
+    conns.connect(sig, 5, [](std::vector<int>& order) { order.push_back(5); });
+    conns.connect(sig, 100, [](std::vector<int>& order) { order.push_back(101); }); // same priority: after the first one
+    conns.connect(sig, -10, [](std::vector<int>& order) { order.push_back(-11); });
+
+    std::vector<int> order;
+    sig.fire(order);
+    CUTE_ASSERT((order == std::vector<int>{ 100, 101, 5, 0, -10, -11 }));
+
+    // targets connected without priority go in front of the ones with a negative priority
+    std::vector<std::function<void(std::vector<int>& order)>> targets(2, [](std::vector<int>& order) { order.push_back(1); });
+    auto more = sig.connect_all(targets);
+
+    // the order is kept while disconnected targets get compacted away
+    logging.disconnect();
+    for(int i = 0; i < 3; ++i) {
+        order.clear();
+        sig.fire(order);
+        CUTE_ASSERT((order == std::vector<int>{ 100, 101, 5, 0, 1, 1, -11 }));
+    }
+
+    for(auto&& c : more) { c.disconnect(); }
+    sig.connect(1000, [](std::vector<int>& order) { order.push_back(1000); });
+    order.clear();
+    sig.fire(order);
+    CUTE_ASSERT((order == std::vector<int>{ 1000, 100, 101, 5, 0, -11 }));
+}
+
+CUTE_TEST(
+    "test firing a signal asynchronously on a thread_pool",
+    "[signals],[signals_25],[thread_pool],[multi-threaded]"
+) {
+    signals::signal<void(std::string const& text, int v)> sig;
+
+    std::atomic<int> sum(0);
+    std::atomic<int> length(0);
+    auto conn1 = sig.connect([&](std::string const& text, int v) { sum += v; length += int(text.size()); });
+    auto conn2 = sig.connect([&](std::string const&, int v) { sum += 10 * v; });
+
+    {
+        signals::thread_pool pool(2);
+        for(int i = 0; i < 100; ++i) {
+            std::string text = "abc";
+            sig.post(pool, text, 1);
+        } // the arguments got copied
+    } // the destructor of the pool executes all pending tasks
+
+    CUTE_ASSERT(length == 300);
+    CUTE_ASSERT(sum == 1100);
+    conn1.disconnect();
+    conn2.disconnect();
+
+    // `disconnect(true)` waits for a running queued call
+    signals::thread_pool pool(2);
+    std::atomic<bool> entered(false);
+    std::atomic<bool> finished(false);
+    auto slow = sig.connect([&](std::string const&, int) {
+        entered = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        finished = true;
+    });
+    sig.post(pool, std::string(), 0);
+    while(!entered) { std::this_thread::yield(); }
+    slow.disconnect(true);
+    CUTE_ASSERT(finished);
+
+    // the default pool
+    std::atomic<int> calls(0);
+    auto conn3 = sig.connect([&](std::string const&, int) { ++calls; });
+    sig.fire_async(std::string("x"), 2);
+    while(calls == 0) { std::this_thread::yield(); }
+    conn3.disconnect(true);
+    CUTE_ASSERT(calls == 1);
+}
+
+CUTE_TEST(
+    "test that an exception thrown by an asynchronously called target does not stop the thread_pool",
+    "[signals],[signals_25],[thread_pool],[multi-threaded]"
+) {
+    signals::signal<void(int v)> sig;
+
+    std::atomic<int> sum(0);
+    auto conn1 = sig.connect([&](int v) { if(v < 0) { throw std::runtime_error("negative value"); } });
+    auto conn2 = sig.connect([&](int v) { sum += v; });
+
+    std::atomic<int> errors(0);
+    {
+        signals::thread_pool pool(1);
+        pool.set_exception_handler([&](std::exception_ptr error) {
+            try { std::rethrow_exception(error); } catch(std::runtime_error const&) { ++errors; }
+        });
+        for(int i = 0; i < 10; ++i) { sig.post(pool, ((i % 2) ? -1 : 1)); }
+    } // the destructor of the pool executes all pending tasks
+
+    CUTE_ASSERT(errors == 5);
+    CUTE_ASSERT(sum == 0);
+
+    // without a handler the exceptions get dropped
+    {
+        signals::thread_pool pool(1);
+        sig.post(pool, -1);
+        sig.post(pool, 2);
+    }
+    CUTE_ASSERT(sum == 1);
+
+    // the running calls got released, so disconnecting does not block
+    conn1.disconnect(true);
+    conn2.disconnect(true);
+}
+
+CUTE_TEST(
+    "test that queued calls of disconnected targets get dropped",
+    "[signals],[signals_25],[single-threaded]"
+) {
+    struct manual_executor {
+        void post(std::function<void()> task) { tasks.push_back(std::move(task)); }
+        void run() { for(auto&& t : tasks) { t(); } tasks.clear(); }
+        std::vector<std::function<void()>> tasks;
+    };
+
+    manual_executor executor;
+    int value = 0;
+    {
+        signals::signal<void(int v)> sig;
+        auto conn = sig.connect([&](int v) { value += v; });
+        sig.connect([&](int v) { value += 100 * v; });
+
+        sig.post(executor, 1);
+        sig.post(executor, 2);
+        CUTE_ASSERT(executor.tasks.size() == 4);
+        CUTE_ASSERT(value == 0);
+
+        conn.disconnect();
+        executor.run();
+        CUTE_ASSERT(value == 300);
+
+        // a copied task gets executed only once
+        sig.post(executor, 3);
+        CUTE_ASSERT(executor.tasks.size() == 1);
+        executor.tasks.push_back(executor.tasks.front());
+        executor.run();
+        CUTE_ASSERT(value == 600);
+
+        // tasks disposed without being executed do not block the destructor of the signal
+        sig.post(executor, 4);
+        CUTE_ASSERT(executor.tasks.size() == 1);
+        executor.tasks.clear();
+    }
+    CUTE_ASSERT(value == 600);
+
+    // same for an event_loop destroyed with pending tasks
+    {
+        signals::signal<void(int v)> sig;
+        sig.connect([&](int v) { value += v; });
+        {
+            signals::event_loop loop;
+            sig.post(loop, 1);
+        }
+    }
+    CUTE_ASSERT(value == 600);
+}
+
+CUTE_TEST(
+    "test that a throwing executor releases the running calls of its queued calls exactly once",
+    "[signals],[signals_25],[single-threaded]"
+) {
+    struct throwing_executor {
+        void post(std::function<void()>) { throw std::runtime_error("executor is full"); }
+    };
+
+    throwing_executor executor;
+    signals::signal<void(int v)> sig;
+    int value = 0;
+    auto conn = sig.connect([&](int v) { value += v; });
+
+    for(int i = 0; i < 3; ++i) {
+        try {
+            sig.post(executor, 1);
+            CUTE_ASSERT(false);
+        } catch(std::runtime_error const&) { }
+    }
+    CUTE_ASSERT(value == 0);
+
+    // no running call is left over, so waiting for them returns right away
+    CUTE_ASSERT(conn.connected());
+    sig.fire(1);
+    CUTE_ASSERT(value == 1);
+    CUTE_ASSERT(conn.disconnect(true));
+}
+
+CUTE_TEST(
+    "test delivering the calls of queued connections on the thread of an event_loop",
+    "[signals],[signals_26],[event_loop],[multi-threaded]"
+) {
+    signals::event_loop loop;
+    signals::signal<void(int v, double d)> sig;
+
+    std::thread::id loop_thread;
+    std::vector<int> values;
+    std::atomic<int> received(0);
+    auto conn = sig.connect(loop, [&](int v, double d) {
+        CUTE_ASSERT(std::this_thread::get_id() == loop_thread);
+        values.push_back(v + int(d));
+        ++received;
+    });
+
+    cute::thread consumer([&]() {
+        loop_thread = std::this_thread::get_id();
+        loop.run();
+    });
+
+    // fire from several threads; more events than cells in the slab
+    std::vector<cute::thread> producers;
+    for(int t = 0; t < 3; ++t) {
+        producers.emplace_back([&]() { for(int i = 0; i < 500; ++i) { sig.fire(1, 0.5); } });
+    }
+    for(auto&& p : producers) { p.join(); }
+    while(received < 1500) { std::this_thread::yield(); }
+
+    loop.stop();
+    consumer.join();
+
+    CUTE_ASSERT(values.size() == 1500);
+    CUTE_ASSERT(std::count(values.begin(), values.end(), 1) == 1500);
+    CUTE_ASSERT(conn.disconnect(true));
+}
+
+CUTE_TEST(
+    "test polling an event_loop and dropping events of disconnected queued connections",
+    "[signals],[signals_26],[event_loop],[single-threaded]"
+) {
+    signals::event_loop loop;
+    std::string text;
+    {
+        signals::signal<void(std::string const& s)> sig;
+        auto conn1 = sig.connect(loop, [&](std::string const& s) { text += s; });
+        auto conn2 = sig.connect(loop, [&](std::string const& s) { text += s + s; });
+
+        sig.fire("a");
+        sig.fire("b");
+        CUTE_ASSERT(text.empty()); // nothing delivered before the loop runs
+        CUTE_ASSERT(loop.poll() == 4);
+        CUTE_ASSERT(text == "aaabbb");
+
+        sig.fire("c");
+        conn2.disconnect();
+        CUTE_ASSERT(loop.run_one());
+        CUTE_ASSERT(loop.poll() == 1); // gets executed, but the target is not called anymore
+        CUTE_ASSERT(text == "aaabbbc");
+
+        // the event_loop can serve as an executor as well
+        signals::connection conn3 = sig.connect([&](std::string const& s) { text += s; });
+        sig.post(loop, std::string("d"));
+        conn1.disconnect();
+        CUTE_ASSERT(loop.poll() == 2);
+        CUTE_ASSERT(text == "aaabbbcd");
+
+        sig.fire("e"); // only conn3 is still connected
+        CUTE_ASSERT(text == "aaabbbcde");
+        conn3.disconnect();
+    }
+
+    // destroying the signal on the loop's thread before the loop drained does not
+    // wait for the pending events, they get dropped
+    {
+        signals::signal<void(std::string const& s)> sig;
+        sig.connect(loop, [&](std::string const& s) { text += s; });
+        sig.fire("f");
+    }
+    CUTE_ASSERT(loop.poll() == 1);
+    CUTE_ASSERT(text == "aaabbbcde");
+
+    loop.stop();
+    CUTE_ASSERT(!loop.run_one());
+}
+
+namespace {
+    /// Counts the allocated and not yet deallocated bytes of all copies (and rebound copies).
+    template<typename T>
+    struct counting_allocator {
+        typedef T value_type;
+
+        counting_allocator(std::shared_ptr<std::atomic<long>> b) : bytes(std::move(b)) { }
+        template<typename U> counting_allocator(counting_allocator<U> const& o) : bytes(o.bytes) { }
+
+        T* allocate(std::size_t n) { *bytes += long(n * sizeof(T)); return static_cast<T*>(::operator new(n * sizeof(T))); }
+        void deallocate(T* p, std::size_t n) { *bytes -= long(n * sizeof(T)); ::operator delete(p); }
+
+        template<typename U> bool operator==(counting_allocator<U> const& o) const { return (bytes == o.bytes); }
+        template<typename U> bool operator!=(counting_allocator<U> const& o) const { return (bytes != o.bytes); }
+
+        std::shared_ptr<std::atomic<long>> bytes;
+    };
+} // namespace
+
+CUTE_TEST(
+    "test that queued connections allocate their event cells via the allocator of the signal",
+    "[signals],[signals_26],[event_loop],[single-threaded]"
+) {
+    auto bytes = std::make_shared<std::atomic<long>>(0);
+    int sum = 0;
+    signals::event_loop loop;
+    {
+        typedef signals::signal<void(int v), std::function<void(int v)>, counting_allocator<void>> counted_signal;
+        counted_signal sig((counting_allocator<void>(bytes)));
+        auto conn = sig.connect(loop, [&](int v) { sum += v; });
+
+        // the slab of event cells and its free list are part of the connection's allocations
+        const long connected = *bytes;
+        CUTE_ASSERT(connected > long(64 * sizeof(int)));
+
+        // overflowing the slab allocates further cells via the allocator as well
+        for(int i = 0; i < 100; ++i) { sig.fire(1); }
+        CUTE_ASSERT(*bytes > connected);
+        CUTE_ASSERT(loop.poll() == 100);
+        CUTE_ASSERT(*bytes == connected);
+        CUTE_ASSERT(sum == 100);
+        conn.disconnect();
+    }
+    CUTE_ASSERT(*bytes == 0);
+}
+
+CUTE_TEST(
+    "test firing a signal in parallel on a thread_pool with a parallel reduction",
+    "[signals],[signals_27],[thread_pool],[multi-threaded]"
+) {
+    signals::signal<int(int v)> sig;
+    const int slot_count = 5000;
+
+    std::vector<std::atomic<int>> calls(slot_count);
+    std::vector<signals::connection> conns;
+    for(int i = 0; i < slot_count; ++i) {
+        calls[i] = 0;
+        conns.push_back(sig.connect([&calls, i](int v) { calls[i] += v; return i; }));
+    }
+
+    signals::thread_pool pool(2);
+    signals::parallel_options options;
+    options.chunk_size = 100;
+    options.serial_threshold = 1000;
+    options.max_tasks = 3;
+
+    sig.fire_parallel_on(pool, options, 2);
+    CUTE_ASSERT(std::all_of(calls.begin(), calls.end(), [](std::atomic<int> const& c) { return (c == 2); }));
+
+    auto sum = sig.fire_parallel_collect_on(pool, options, signals::combiners::sum<long long>(), 1);
+    CUTE_ASSERT(sum == (long long)(slot_count) * (slot_count - 1) / 2);
+    CUTE_ASSERT(std::all_of(calls.begin(), calls.end(), [](std::atomic<int> const& c) { return (c == 3); }));
+
+    auto max = sig.fire_parallel_collect_on(pool, options, signals::combiners::max<int>(), 0);
+    CUTE_ASSERT(max == slot_count - 1);
+
+    // initial values count only once, as with the serial `fire_collect()`
+    const long long expected = (long long)(slot_count) * (slot_count - 1) / 2;
+    CUTE_ASSERT(sig.fire_parallel_collect_on(pool, options, signals::combiners::sum<long long>(100), 0) == expected + 100);
+    CUTE_ASSERT(sig.fire_collect(signals::combiners::sum<long long>(100), 0) == expected + 100);
+
+    auto plus = [](long long acc, int v) { return acc + v; };
+    auto folded = sig.fire_parallel_collect_on(pool, options, signals::combiners::make_fold(7LL, plus), 0);
+    CUTE_ASSERT(folded == expected + 7);
+
+    // a non-trivial seed with a custom `identity` of the fold operation
+    signals::signal<long long()> factors;
+    std::vector<signals::connection> factor_conns;
+    for(int i = 0; i < 2000; ++i) { factor_conns.push_back(factors.connect([i]() { return (i % 100 == 0) ? 2LL : 1LL; })); }
+    auto times = [](long long acc, long long v) { return acc * v; };
+    CUTE_ASSERT(factors.fire_parallel_collect_on(pool, options, signals::combiners::make_fold(3LL, times, 1LL)) == 3LL << 20);
+    CUTE_ASSERT(factors.fire_collect(signals::combiners::make_fold(3LL, times, 1LL)) == 3LL << 20);
+    for(auto&& c : factor_conns) { c.disconnect(); }
+
+    // disconnected targets are skipped
+    for(int i = 0; i < slot_count; i += 2) { conns[i].disconnect(); }
+    sig.fire_parallel_on(pool, options, 1);
+    CUTE_ASSERT(calls[0] == 3);
+    CUTE_ASSERT(calls[1] == 4);
+
+    // the first exception gets rethrown once all chunks are done
+    auto thrower = sig.connect([](int v) -> int { if(v == 42) { throw std::runtime_error("42"); } return 0; });
+    bool caught = false;
+    try {
+        sig.fire_parallel_on(pool, options, 42);
+    } catch(std::runtime_error const&) {
+        caught = true;
+    }
+    CUTE_ASSERT(caught);
+    CUTE_ASSERT(calls[1] == 46);
+    CUTE_ASSERT(calls[slot_count - 1] == 46);
+    thrower.disconnect();
+}
+
+CUTE_TEST(
+    "test that firing a small signal in parallel falls back to the serial loop",
+    "[signals],[signals_27],[single-threaded]"
+) {
+    struct counting_executor {
+        void post(std::function<void()> task) { ++posted; task(); }
+        int posted;
+    };
+
+    signals::signal<int(int v)> sig;
+    std::vector<std::thread::id> threads;
+    auto conn1 = sig.connect([&](int v) { threads.push_back(std::this_thread::get_id()); return v; });
+    auto conn2 = sig.connect([&](int v) { threads.push_back(std::this_thread::get_id()); return 2 * v; });
+
+    counting_executor executor = { 0 };
+    signals::parallel_options options; // default threshold is way above two targets
+    options.max_tasks = 4;
+    sig.fire_parallel_on(executor, options, 1);
+    CUTE_ASSERT(executor.posted == 0);
+    CUTE_ASSERT(threads.size() == 2);
+    CUTE_ASSERT(threads[0] == std::this_thread::get_id());
+    CUTE_ASSERT(threads[1] == std::this_thread::get_id());
+
+    CUTE_ASSERT(sig.fire_parallel_collect_on(executor, options, signals::combiners::sum<int>(), 3) == 9);
+    CUTE_ASSERT(executor.posted == 0);
+
+    // one target per chunk: the executor gets the chunks except for the caller's one
+    options.chunk_size = 1;
+    options.serial_threshold = 0;
+    CUTE_ASSERT(sig.fire_parallel_collect_on(executor, options, signals::combiners::sum<int>(), 3) == 9);
+    CUTE_ASSERT(executor.posted == 1);
+
+    conn1.disconnect();
+    conn2.disconnect();
+}
+
+CUTE_TEST(
+    "test that a coalescing_signal collapses fires until the next flush",
+    "[signals],[signals_28],[coalescing],[single-threaded]"
+) {
+    signals::coalescing_signal<void(std::string const& name, int v)> sig;
+    std::vector<std::string> names;
+    int sum = 0;
+    auto conn = sig.connect([&](std::string const& name, int v) { names.push_back(name); sum += v; });
+
+    CUTE_ASSERT(!sig.pending());
+    CUTE_ASSERT(!sig.flush());
+
+    sig.fire("a", 1);
+    sig.fire("b", 2);
+    sig.fire(std::string("c"), 3);
+    CUTE_ASSERT(sig.pending());
+    CUTE_ASSERT(names.empty());
+
+    CUTE_ASSERT(sig.flush());
+    CUTE_ASSERT(!sig.pending());
+    CUTE_ASSERT((names == std::vector<std::string>{ "c" }));
+    CUTE_ASSERT(sum == 3);
+    CUTE_ASSERT(!sig.flush());
+
+    sig.fire("d", 4);
+    CUTE_ASSERT(sig.discard());
+    CUTE_ASSERT(!sig.flush());
+    CUTE_ASSERT(names.size() == 1);
+
+    // merging the pending arguments with the latest ones
+    struct add_deltas {
+        void operator()(std::tuple<int>& pending, std::tuple<int>&& latest) const { std::get<0>(pending) += std::get<0>(latest); }
+    };
+    signals::coalescing_signal<void(int delta), add_deltas> deltas;
+    int total = 0, dispatches = 0;
+    auto conn2 = deltas.connect([&](int delta) { total += delta; ++dispatches; });
+    for(int i = 1; i <= 10; ++i) { deltas.fire(i); }
+    CUTE_ASSERT(deltas.flush());
+    CUTE_ASSERT(total == 55);
+    CUTE_ASSERT(dispatches == 1);
+
+    // auto flush via an event_loop
+    signals::event_loop loop;
+    sig.auto_flush(loop);
+    sig.fire("e", 5);
+    sig.fire("f", 6);
+    CUTE_ASSERT(loop.poll() == 1); // a single flush task got posted
+    CUTE_ASSERT((names == std::vector<std::string>{ "c", "f" }));
+    sig.fire("g", 7);
+    CUTE_ASSERT(loop.poll() == 1);
+    CUTE_ASSERT((names == std::vector<std::string>{ "c", "f", "g" }));
+    CUTE_ASSERT(loop.poll() == 0);
+
+    conn.disconnect();
+    conn2.disconnect();
+}
+
+CUTE_TEST(
+    "test firing a coalescing_signal concurrently to flushing it",
+    "[signals],[signals_28],[coalescing],[multi-threaded]"
+) {
+    // a single producer: the flushed values are strictly increasing and the final
+    // flush delivers the last one
+    signals::coalescing_signal<void(int v)> sig;
+    int last = 0;
+    bool increasing = true;
+    auto conn = sig.connect([&](int v) { increasing = increasing && (v > last); last = v; });
+
+    const int count = 100000;
+    std::thread producer([&]() { for(int i = 1; i <= count; ++i) { sig.fire(i); } });
+    while(last < count) { sig.flush(); }
+    producer.join();
+    CUTE_ASSERT(increasing);
+    CUTE_ASSERT(last == count);
+    CUTE_ASSERT(!sig.flush());
+
+    // several producers merging deltas: nothing gets lost
+    struct add_deltas {
+        void operator()(std::tuple<int>& pending, std::tuple<int>&& latest) const { std::get<0>(pending) += std::get<0>(latest); }
+    };
+    signals::coalescing_signal<void(int delta), add_deltas> deltas;
+    long long total = 0;
+    auto conn2 = deltas.connect([&](int delta) { total += delta; });
+
+    std::atomic<int> running(4);
+    std::vector<std::thread> producers;
+    for(int t = 0; t < 4; ++t) {
+        producers.emplace_back([&]() {
+            for(int i = 0; i < 20000; ++i) { deltas.fire(1); }
+            --running;
+        });
+    }
+    while(running > 0) { deltas.flush(); }
+    for(auto&& p : producers) { p.join(); }
+    deltas.flush();
+    CUTE_ASSERT(total == 80000);
+
+    conn.disconnect();
+    conn2.disconnect();
+}
+
+CUTE_TEST(
+    "test throttling the calls of a connection",
+    "[signals],[signals_29],[throttle],[single-threaded]"
+) {
+    // the rate limit itself: one call per `interval / max_calls`, no bursts
+    signals::throttle limit(4, std::chrono::milliseconds(100));
+    auto t0 = signals::throttle::clock_type::now();
+    CUTE_ASSERT(limit.try_acquire(t0));
+    CUTE_ASSERT(!limit.try_acquire(t0));
+    CUTE_ASSERT(!limit.try_acquire(t0 + std::chrono::milliseconds(10)));
+    CUTE_ASSERT(limit.try_acquire(t0 + std::chrono::milliseconds(25)));
+    CUTE_ASSERT(!limit.try_acquire(t0 + std::chrono::milliseconds(25)));
+    CUTE_ASSERT(limit.try_acquire(t0 + std::chrono::milliseconds(1000)));
+    CUTE_ASSERT(limit.delivered() == 3);
+    CUTE_ASSERT(limit.suppressed() == 3);
+    limit.reset_counters();
+    CUTE_ASSERT(limit.delivered() == 0);
+    CUTE_ASSERT(limit.suppressed() == 0);
+
+    // firing every millisecond across several intervals: any window of length
+    // `interval` holds at most `max_calls` delivered calls
+    signals::throttle paced(4, std::chrono::milliseconds(100));
+    std::vector<int> delivered_at;
+    for(int ms = 0; ms < 300; ++ms) {
+        if(paced.try_acquire(t0 + std::chrono::milliseconds(ms))) { delivered_at.push_back(ms); }
+    }
+    CUTE_ASSERT(delivered_at.size() == 12);
+    for(int start = 0; start < 300; ++start) {
+        auto in_window = std::count_if(delivered_at.begin(), delivered_at.end(), [&](int ms) { return ((ms >= start) && (ms < start + 100)); });
+        CUTE_ASSERT(in_window <= 4);
+    }
+
+    // a throttled connection next to an unthrottled one
+    signals::signal<void(int v)> sig;
+    signals::throttle per_hour(3, std::chrono::hours(1));
+    int throttled_sum = 0, sum = 0;
+    auto conn1 = sig.connect(per_hour, [&](int v) { throttled_sum += v; });
+    auto conn2 = sig.connect([&](int v) { sum += v; });
+
+    for(int i = 1; i <= 10; ++i) { sig.fire(i); }
+    CUTE_ASSERT(sum == 55);
+    CUTE_ASSERT(throttled_sum == 1);
+    CUTE_ASSERT(per_hour.delivered() == 1);
+    CUTE_ASSERT(per_hour.suppressed() == 9);
+
+    // connections sharing a throttle share its budget
+    signals::throttle shared(2, std::chrono::hours(1));
+    int calls = 0;
+    auto conn3 = sig.connect(shared, [&](int) { ++calls; });
+    auto conn4 = sig.connect(shared, [&](int) { ++calls; });
+    sig.fire(0);
+    sig.fire(0);
+    CUTE_ASSERT(calls == 1);
+    CUTE_ASSERT(shared.suppressed() == 3);
+
+    conn1.disconnect();
+    conn2.disconnect();
+    conn3.disconnect();
+    conn4.disconnect();
+
+    // the forwarder stored in the signal is a single pointer, it fits into the
+    // smallest inline target (the actual target lives in the slot node)
+    signals::signal<void(int v), signals::inplace_function<void(int v), sizeof(void*)>> small;
+    signals::throttle twice(2, std::chrono::hours(1));
+    int small_sum = 0;
+    auto conn5 = small.connect(twice, [&small_sum](int v) { small_sum += v; });
+    for(int i = 0; i < 5; ++i) { small.fire(1); }
+    CUTE_ASSERT(small_sum == 1);
+    CUTE_ASSERT(twice.suppressed() == 4);
+    conn5.disconnect();
+}
+
+CUTE_TEST(
+    "test that a throttle never lets more calls pass than allowed under contention",
+    "[signals],[signals_29],[throttle],[multi-threaded]"
+) {
+    signals::signal<void()> sig;
+    signals::throttle limit(1000, std::chrono::hours(1));
+    std::atomic<int> calls(0);
+    auto conn = sig.connect(limit, [&]() { ++calls; });
+
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() { for(int i = 0; i < 5000; ++i) { sig.fire(); } });
+    }
+    for(auto&& t : threads) { t.join(); }
+
+    // the next call is allowed only 3.6 seconds after the first one
+    CUTE_ASSERT(calls == 1);
+    CUTE_ASSERT(limit.delivered() == 1);
+    CUTE_ASSERT(limit.suppressed() == 19999);
+    conn.disconnect();
+}
+
+CUTE_TEST(
+    "test firing a signal for a batch of argument tuples",
+    "[signals],[signals_30],[batch],[single-threaded]"
+) {
+    typedef signals::signal<void(std::string const& name, int v)> signal_type;
+    signal_type sig;
+    std::vector<std::string> calls;
+    auto conn1 = sig.connect([&](std::string const& name, int v) { calls.push_back("1:" + name + std::to_string(v)); });
+    auto conn2 = sig.connect([&](std::string const& name, int v) { calls.push_back("2:" + name + std::to_string(v)); });
+
+    std::vector<signal_type::args_tuple> batch;
+    batch.emplace_back("a", 1);
+    batch.emplace_back("b", 2);
+    batch.emplace_back("c", 3);
+
+    // each target gets the whole batch before the next target
+    sig.fire_batch(batch);
+    CUTE_ASSERT((calls == std::vector<std::string>{ "1:a1", "1:b2", "1:c3", "2:a1", "2:b2", "2:c3" }));
+
+    calls.clear();
+    sig.fire_batch(signal_type::batch_span());
+    sig.fire_batch(signal_type::batch_span(batch.data() + 1, 1));
+    CUTE_ASSERT((calls == std::vector<std::string>{ "1:b2", "2:b2" }));
+
+    // batch-aware targets receive the whole batch at once, or a single tuple on `fire()`
+    std::vector<std::size_t> batch_sizes;
+    int batch_sum = 0;
+    auto conn3 = sig.connect_batch([&](signal_type::batch_span b) {
+        batch_sizes.push_back(b.size());
+        for(auto& args : b) { batch_sum += std::get<1>(args); }
+    });
+    conn1.disconnect();
+
+    calls.clear();
+    sig.fire_batch(batch);
+    sig.fire("d", 4);
+    CUTE_ASSERT((calls == std::vector<std::string>{ "2:a1", "2:b2", "2:c3", "2:d4" }));
+    CUTE_ASSERT((batch_sizes == std::vector<std::size_t>{ 3, 1 }));
+    CUTE_ASSERT(batch_sum == 10);
+
+    // a target disconnecting itself does not receive the rest of the batch
+    conn3.disconnect();
+    int self_calls = 0;
+    signals::connection self;
+    self = sig.connect([&](std::string const&, int) { ++self_calls; self.disconnect(); });
+    calls.clear();
+    sig.fire_batch(batch);
+    CUTE_ASSERT(self_calls == 1);
+    CUTE_ASSERT(calls.size() == 3);
+
+    conn2.disconnect();
+
+    // batch targets with a custom allocator
+    typedef signals::signal<void(int v), std::function<void(int v)>, signals::pool_allocator<void>> pool_signal;
+    pool_signal psig;
+    int psum = 0;
+    auto conn4 = psig.connect_batch([&](pool_signal::batch_span b) { for(auto& args : b) { psum += std::get<0>(args); } });
+    std::vector<pool_signal::args_tuple> pbatch = { std::make_tuple(1), std::make_tuple(2) };
+    psig.fire_batch(pbatch);
+    psig.fire(3);
+    CUTE_ASSERT(psum == 6);
+    conn4.disconnect();
+}
+
+CUTE_TEST(
+    "test a single-threaded signal",
+    "[signals],[signals_31],[threading],[single-threaded]"
+) {
+    typedef signals::signal<int(int v), std::function<int(int v)>, std::allocator<void>, signals::threading::single_threaded> signal_type;
+    signal_type sig;
+    int sum = 0;
+    auto conn1 = sig.connect([&](int v) { sum += v; return v; });
+    sig.fire(1);
+    CUTE_ASSERT(sum == 1);
+
+    // targets connecting and disconnecting while the signal gets fired
+    std::vector<signals::connection> added;
+    signals::connection conn2;
+    conn2 = sig.connect([&](int v) {
+        conn2.disconnect();
+        for(int i = 0; i < 100; ++i) { added.push_back(sig.connect([&](int w) { sum += w; return w; })); }
+        return v;
+    });
+    sig.fire(1);
+    CUTE_ASSERT(sum == 2); // the added targets are not called during this fire
+    CUTE_ASSERT(!conn2.connected());
+    sig.fire(1);
+    CUTE_ASSERT(sum == 103);
+
+    CUTE_ASSERT(sig.fire_collect(signals::combiners::sum<int>(), 2) == 202);
+    for(auto&& c : added) { c.disconnect(true); }
+    CUTE_ASSERT(sig.fire_collect(signals::combiners::sum<int>(), 2) == 2);
+
+    signal_type moved(std::move(sig));
+    sig.fire(1);
+    moved.fire(1);
+    CUTE_ASSERT(sum == 103 + 202 + 2 + 1);
+    conn1.disconnect();
+}
+
+CUTE_TEST(
+    "test connecting and firing a signal with a spinlock policy concurrently",
+    "[signals],[signals_31],[threading],[multi-threaded]"
+) {
+    signals::signal<void(int v), std::function<void(int v)>, std::allocator<void>, signals::threading::spinlock> sig;
+    std::atomic<int> sum(0);
+
+    std::atomic<bool> done(false);
+    std::thread firing([&]() { while(!done) { sig.fire(1); } });
+
+    std::vector<std::thread> writers;
+    for(int t = 0; t < 2; ++t) {
+        writers.emplace_back([&]() {
+            for(int i = 0; i < 500; ++i) {
+                auto conn = sig.connect([&](int v) { sum += v; });
+                if(i % 2) { conn.disconnect(true); }
+            }
+        });
+    }
+    for(auto&& w : writers) { w.join(); }
+    done = true;
+    firing.join();
+
+    sum = 0;
+    sig.fire(1);
+    CUTE_ASSERT(sum == 500);
+    sig.disconnect_all(true);
+    sig.fire(1);
+    CUTE_ASSERT(sum == 500);
+}
+
+namespace {
+    int g_static_total = 0;
+    void add_once(int v) { g_static_total += v; }
+    void add_twice(int v) { g_static_total += 2 * v; }
+
+    struct static_receiver {
+        static_receiver() : sum(0) { }
+        void on_value(int v) { sum += v; }
+        int sum;
+    };
+} // namespace
+
+CUTE_TEST(
+    "test a static_signal with inline slots",
+    "[signals],[signals_32],[static_signal],[single-threaded]"
+) {
+    // constant-initialized from plain functions
+    static constexpr signals::static_signal<void(int), 4, void (*)(int)> constant(&add_once, &add_twice);
+    constant.fire(1);
+    CUTE_ASSERT(g_static_total == 3);
+    CUTE_ASSERT(constant.capacity() == 4);
+
+    signals::static_signal<void(int), 3> sig;
+    static_receiver r1, r2, r3, r4;
+    auto conn1 = sig.connect<static_receiver, &static_receiver::on_value>(&r1);
+    auto conn2 = sig.connect(signals::delegate<void(int)>::bind<static_receiver, &static_receiver::on_value>(&r2));
+    {
+        signals::connections conns;
+        conns.connect(sig, signals::delegate<void(int)>::bind<static_receiver, &static_receiver::on_value>(&r3));
+        sig.fire(1);
+        CUTE_ASSERT(r1.sum == 1);
+        CUTE_ASSERT(r2.sum == 1);
+        CUTE_ASSERT(r3.sum == 1);
+
+        // all slots in use
+        bool thrown = false;
+        try {
+            sig.connect<static_receiver, &static_receiver::on_value>(&r4);
+        } catch(std::length_error const&) {
+            thrown = true;
+        }
+        CUTE_ASSERT(thrown);
+    } // `conns` disconnects `r3` and releases its slot
+    sig.fire(1);
+    CUTE_ASSERT(r3.sum == 1);
+
+    auto conn4 = sig.connect<static_receiver, &static_receiver::on_value>(&r4);
+    sig.fire(1);
+    CUTE_ASSERT(r4.sum == 1);
+
+    // a disconnected slot still referenced by a handle does not get reused
+    conn2.disconnect();
+    CUTE_ASSERT(!conn2.connected());
+    bool thrown = false;
+    try {
+        sig.connect<static_receiver, &static_receiver::on_value>(&r3);
+    } catch(std::length_error const&) {
+        thrown = true;
+    }
+    CUTE_ASSERT(thrown);
+    conn2 = signals::connection();
+    auto conn3 = sig.connect<static_receiver, &static_receiver::on_value>(&r3);
+    sig.fire(1);
+    CUTE_ASSERT(r1.sum == 4);
+    CUTE_ASSERT(r2.sum == 3);
+    CUTE_ASSERT(r3.sum == 2);
+    CUTE_ASSERT(r4.sum == 2);
+
+    CUTE_ASSERT((sig.disconnect_all(true) == std::chrono::steady_clock::duration::zero()));
+    CUTE_ASSERT(!conn1.connected());
+    sig.fire(1);
+    CUTE_ASSERT(r1.sum == 4);
+}
+
+namespace {
+    /// Generic code working with a `signal` as well as with a `static_signal`.
+    template<typename SIGNAL>
+    int connect_fire_and_disconnect(SIGNAL& sig) {
+        static_receiver r;
+        signals::connection conn = sig.template connect<static_receiver, &static_receiver::on_value>(&r);
+        sig.fire(2);
+        auto waited = sig.disconnect_all(true);
+        CUTE_ASSERT((waited == std::chrono::steady_clock::duration::zero()));
+        CUTE_ASSERT(!conn.connected());
+        sig.fire(2);
+        return r.sum;
+    }
+} // namespace
+
+CUTE_TEST(
+    "test switching between signal and static_signal by changing the type",
+    "[signals],[signals_32],[static_signal],[single-threaded]"
+) {
+    signals::signal<void(int)> dynamic_sig;
+    signals::static_signal<void(int), 4> static_sig;
+    CUTE_ASSERT(connect_fire_and_disconnect(dynamic_sig) == 2);
+    CUTE_ASSERT(connect_fire_and_disconnect(static_sig) == 2);
+
+    // with the same `TARGET` type both accept the same targets
+    typedef signals::delegate<void(int)> target;
+    signals::signal<void(int), target> dynamic_delegates;
+    signals::static_signal<void(int), 4, target> static_delegates;
+    static_receiver r;
+    dynamic_delegates.connect(target::bind<static_receiver, &static_receiver::on_value>(&r));
+    static_delegates.connect(target::bind<static_receiver, &static_receiver::on_value>(&r));
+    dynamic_delegates.fire(1);
+    static_delegates.fire(1);
+    CUTE_ASSERT(r.sum == 2);
+}
+
+CUTE_TEST(
+    "test a realtime_signal",
+    "[signals],[signals_33],[realtime],[single-threaded]"
+) {
+    signals::realtime_signal<void(int v)> sig(2);
+    int sum = 0;
+    auto conn1 = sig.connect([&](int v) { sum += v; });
+    auto conn2 = sig.connect([&](int v) { sum += 10 * v; });
+    sig.fire(1);
+    CUTE_ASSERT(sum == 11);
+    CUTE_ASSERT(sig.retired() == 0); // appended in place
+
+    // growing the capacity hands the old snapshot off to `reclaim()`
+    auto conn3 = sig.connect([&](int v) { sum += 100 * v; });
+    CUTE_ASSERT(sig.retired() == 1);
+    sig.fire(1);
+    CUTE_ASSERT(sum == 122);
+    CUTE_ASSERT(sig.reclaim() == 1);
+    CUTE_ASSERT(sig.reclaim() == 0);
+
+    CUTE_ASSERT(sig.disconnect(conn2));
+    sig.fire(1);
+    CUTE_ASSERT(sum == 223);
+
+    // the target of a collected connection gets released by `reclaim()`
+    auto tracker = std::make_shared<int>(0);
+    std::weak_ptr<int> weak = tracker;
+    auto conn4 = sig.connect([tracker](int) { });
+    tracker.reset();
+    conn4.disconnect();
+    conn4 = signals::connection();
+    sig.collect();
+    CUTE_ASSERT(!weak.expired()); // still referenced by the old snapshot
+    CUTE_ASSERT(sig.reclaim() == 1);
+    CUTE_ASSERT(weak.expired());
+
+    sig.disconnect_all();
+    sig.fire(1);
+    CUTE_ASSERT(sum == 223);
+    CUTE_ASSERT(!conn1.connected());
+    CUTE_ASSERT(!conn3.connected());
+}
+
+CUTE_TEST(
+    "test firing a realtime_signal concurrently to connecting, disconnecting and reclaiming",
+    "[signals],[signals_33],[realtime],[multi-threaded]"
+) {
+    signals::realtime_signal<void(int& counter)> sig(4);
+    std::atomic<bool> done(false);
+    std::atomic<long long> calls(0);
+
+    std::thread rt([&]() {
+        while(!done) {
+            int counter = 0;
+            sig.fire(counter);
+            calls += counter;
+        }
+    });
+
+    for(int i = 0; i < 200; ++i) {
+        auto alive = std::make_shared<int>(1);
+        auto conn = sig.connect([alive](int& counter) { counter += *alive; });
+        if(i % 3 == 0) { sig.disconnect(conn); }
+        if(i % 10 == 0) { sig.collect(); }
+        if(i % 7 == 0) { sig.reclaim(); }
+    }
+    done = true;
+    rt.join();
+
+    sig.disconnect_all();
+    sig.reclaim();
+    CUTE_ASSERT(sig.retired() == 0);
+}
+
+CUTE_TEST(
+    "test that waiting disconnects of realtime_signal connections wait for running fire() calls",
+    "[signals],[signals_33],[realtime],[multi-threaded]"
+) {
+    signals::realtime_signal<void()> sig;
+    std::atomic<bool> entered(false), finished(false);
+    auto slow = [&]() {
+        entered = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        finished = true;
+    };
+
+    // `connection::disconnect(true)`
+    auto conn = sig.connect(slow);
+    cute::thread rt1([&]() { sig.fire(); });
+    while(!entered) { std::this_thread::yield(); }
+    CUTE_ASSERT(conn.disconnect(true));
+    CUTE_ASSERT(finished);
+    rt1.join();
+
+    // a `scoped_connection` waiting on destruction
+    entered = false; finished = false;
+    std::thread rt2;
+    {
+        signals::scoped_connection scoped(sig.connect(slow), true);
+        rt2 = std::thread([&]() { sig.fire(); });
+        while(!entered) { std::this_thread::yield(); }
+    }
+    CUTE_ASSERT(finished);
+    rt2.join();
+
+    // a `connections` object waiting in `disconnect_all(true)`
+    entered = false; finished = false;
+    signals::connections conns;
+    conns.add(sig.connect(slow));
+    cute::thread rt3([&]() { sig.fire(); });
+    while(!entered) { std::this_thread::yield(); }
+    CUTE_ASSERT((conns.disconnect_all(true) > std::chrono::steady_clock::duration::zero()));
+    CUTE_ASSERT(finished);
+    rt3.join();
+
+    // waiting via a handle outliving its signal returns immediately
+    signals::connection outliving;
+    {
+        signals::realtime_signal<void()> temp;
+        outliving = temp.connect([]() { });
+    }
+    CUTE_ASSERT(!outliving.disconnect(true));
+}
+
+CUTE_TEST(
+    "test scoped_connection and shared_connection_block",
+    "[signals],[signals_34],[scoped_connection],[single-threaded]"
+) {
+    static_assert(sizeof(signals::scoped_connection) == sizeof(void*), "scoped_connection should be as large as a pointer");
+    static_assert(sizeof(signals::shared_connection_block) == sizeof(void*), "shared_connection_block should be as large as a pointer");
+
+    signals::signal<void(int v)> sig;
+    int sum1 = 0, sum2 = 0;
+    auto conn1 = sig.connect([&](int v) { sum1 += v; });
+    {
+        signals::scoped_connection scoped1 = conn1;
+        signals::scoped_connection scoped2(sig.connect([&](int v) { sum2 += v; }), true);
+        CUTE_ASSERT(scoped1.connected());
+        CUTE_ASSERT(!scoped1.wait_on_destruction());
+        CUTE_ASSERT(scoped2.wait_on_destruction());
+        sig.fire(1);
+
+        // moving transfers the ownership
+        signals::scoped_connection moved(std::move(scoped2));
+        CUTE_ASSERT(!scoped2.connected());
+        CUTE_ASSERT(moved.connected());
+        CUTE_ASSERT(moved.wait_on_destruction());
+
+        // assigning disconnects the previous connection
+        scoped2 = std::move(moved);
+        CUTE_ASSERT(scoped2.connected());
+        scoped2 = signals::scoped_connection();
+        sig.fire(1);
+        CUTE_ASSERT(sum1 == 2);
+        CUTE_ASSERT(sum2 == 1);
+    } // `scoped1` disconnects `conn1`
+    CUTE_ASSERT(!conn1.connected());
+
+    // releasing keeps the connection alive
+    signals::connection released;
+    {
+        signals::scoped_connection scoped = sig.connect([&](int v) { sum1 += v; });
+        released = scoped.release();
+        CUTE_ASSERT(!scoped.connected());
+    }
+    CUTE_ASSERT(released.connected());
+    sig.fire(1);
+    CUTE_ASSERT(sum1 == 3);
+
+    // blocking the calls
+    {
+        signals::shared_connection_block block1(released);
+        CUTE_ASSERT(block1.blocking());
+        CUTE_ASSERT(released.blocked());
+        sig.fire(1);
+        CUTE_ASSERT(sum1 == 3);
+        CUTE_ASSERT(released.connected());
+
+        {
+            signals::shared_connection_block block2(released);
+            block1.unblock();
+            CUTE_ASSERT(!block1.blocking());
+            sig.fire(1);
+            CUTE_ASSERT(sum1 == 3); // still blocked by `block2`
+        }
+        CUTE_ASSERT(!released.blocked());
+        sig.fire(1);
+        CUTE_ASSERT(sum1 == 4);
+
+        block1.block();
+        block1.block(); // blocks only once
+        signals::shared_connection_block block3(std::move(block1));
+        CUTE_ASSERT(!block1.blocking());
+        CUTE_ASSERT(block3.blocking());
+        sig.fire(1);
+        CUTE_ASSERT(sum1 == 4);
+    }
+    CUTE_ASSERT(!released.blocked());
+    sig.fire(1);
+    CUTE_ASSERT(sum1 == 5);
+
+    // blocked targets are not treated as tombstones and keep their place
+    std::vector<signals::connection> conns;
+    std::vector<signals::shared_connection_block> blocks;
+    int others = 0;
+    for(int i = 0; i < 10; ++i) {
+        conns.push_back(sig.connect([&](int) { ++others; }));
+        blocks.emplace_back(conns.back());
+    }
+    sig.fire(1);
+    CUTE_ASSERT(others == 0);
+    blocks.clear();
+    sig.fire(1);
+    CUTE_ASSERT(others == 10);
+
+    released.disconnect();
+    for(auto&& c : conns) { c.disconnect(); }
+}
+
+CUTE_TEST(
+    "test removing single connections from and pruning disconnected ones of a connections object",
+    "[signals],[signals_35],[connections],[single-threaded]"
+) {
+    signals::signal<void(int& counter)> sig;
+    signals::connections conns;
+
+    auto id1 = conns.add(sig.connect([](int& counter) { counter += 1; }));
+    auto id2 = conns.add(sig.connect([](int& counter) { counter += 10; }));
+    CUTE_ASSERT(id1.valid());
+    CUTE_ASSERT(!conns.add(signals::connection()).valid());
+    CUTE_ASSERT(conns.size() == 2);
+
+    // disconnecting a single tracked connection
+    CUTE_ASSERT(conns.disconnect(id1));
+    CUTE_ASSERT(!conns.disconnect(id1));
+    CUTE_ASSERT(conns.size() == 1);
+    int counter = 0;
+    sig.fire(counter);
+    CUTE_ASSERT(counter == 10);
+
+    // the freed slot gets reused, but the stale `id` stays invalid
+    auto id3 = conns.add(sig.connect([](int& counter) { counter += 100; }));
+    CUTE_ASSERT(id3.index == id1.index);
+    CUTE_ASSERT(!conns.remove(id1).connected());
+    CUTE_ASSERT(conns.size() == 2);
+
+    // removing keeps the connection connected
+    auto conn2 = conns.remove(id2);
+    CUTE_ASSERT(conn2.connected());
+    CUTE_ASSERT(conns.size() == 1);
+    counter = 0;
+    sig.fire(counter);
+    CUTE_ASSERT(counter == 110);
+    conn2.disconnect();
+
+    // connections disconnected elsewhere get pruned while adding new ones
+    for(int i = 0; i < 10000; ++i) {
+        conns.add(sig.connect([](int&) { }));
+        auto c = sig.connect([](int&) { });
+        conns.add(c);
+        c.disconnect();
+    }
+    CUTE_ASSERT(conns.size() < 2 * 10000 + 32);
+    CUTE_ASSERT(conns.size() > 10000);
+    CUTE_ASSERT(conns.prune() > 0);
+    CUTE_ASSERT(conns.size() == 10001);
+
+    conns.disconnect_all();
+    CUTE_ASSERT(conns.size() == 0);
+    CUTE_ASSERT(!conns.disconnect(id3));
+
+    // connecting via `track` and `track_many` returns the `id`s for removal
+    auto tracked = conns.track(sig, [](int& counter) { counter += 1000; });
+    std::vector<std::function<void(int& counter)>> targets(3, [](int& counter) { counter += 10000; });
+    auto many = conns.track_many(sig, targets);
+    CUTE_ASSERT(many.size() == 3);
+    CUTE_ASSERT(conns.size() == 4);
+    counter = 0;
+    sig.fire(counter);
+    CUTE_ASSERT(counter == 31000);
+
+    CUTE_ASSERT(conns.disconnect(tracked));
+    CUTE_ASSERT(conns.disconnect(many[1]));
+    CUTE_ASSERT(conns.remove(many[2]).disconnect());
+    CUTE_ASSERT(conns.size() == 1);
+    counter = 0;
+    sig.fire(counter);
+    CUTE_ASSERT(counter == 10000);
+    conns.disconnect_all();
+    counter = 0;
+    sig.fire(counter);
+    CUTE_ASSERT(counter == 0);
+}
+
+CUTE_TEST(
+    "test adding and removing connections of a connections object from several threads",
+    "[signals],[signals_36],[connections],[multi-threaded]"
+) {
+    signals::signal<void(int v)> sig;
+    signals::connections conns;
+    std::atomic<int> calls(0);
+
+    std::vector<cute::thread> threads;
+    for(int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for(int i = 0; i < 1000; ++i) {
+                auto id = conns.add(sig.connect([&](int) { ++calls; }));
+                auto dropped = sig.connect([](int) { });
+                conns.add(dropped);
+                if(i % 2) { CUTE_ASSERT(conns.disconnect(id)); }
+                dropped.disconnect();
+                sig.fire(1);
+            }
+        });
+    }
+    threads.emplace_back([&]() { for(int i = 0; i < 1000; ++i) { conns.prune(); } });
+    for(auto&& t : threads) { t.join(); }
+
+    conns.prune();
+    CUTE_ASSERT(conns.size() == 4 * 500);
+
+    calls = 0;
+    sig.fire(1);
+    CUTE_ASSERT(calls == 4 * 500);
+
+    conns.disconnect_all(true);
+    calls = 0;
+    sig.fire(1);
+    CUTE_ASSERT(calls == 0);
+}